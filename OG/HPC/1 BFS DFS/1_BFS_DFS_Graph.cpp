@@ -19,22 +19,76 @@ public:
         adj[v].push_back(w);
     }
 
+    // Depth-First Search
+    // An explicit stack of (vertex, next neighbor index) frames replaces the recursion
+    // of one call per vertex: a path of millions of vertices cannot overflow the call
+    // stack, and a frame is two ints instead of a whole call frame
+    void DFS(int startVertex) {
+        vector<char> visited(V, 0);
+        vector<pair<int, int>> stack;
+
+        visited[startVertex] = 1;
+        cout << startVertex << " ";
+        stack.push_back({startVertex, 0});
+
+        while (!stack.empty()) {
+            int v = stack.back().first;
+            int next = stack.back().second;
+            if (next == (int)adj[v].size()) {
+                stack.pop_back();  // all neighbors scanned: v is finished
+                continue;
+            }
+            stack.back().second++;
+
+            int n = adj[v][next];
+            if (!visited[n]) {
+                visited[n] = 1;
+                cout << n << " ";
+                stack.push_back({n, 0});
+            }
+        }
+    }
+
     // Parallel Depth-First Search
+    // One thread team for the whole search. Every task walks its own explicit stack of
+    // vertices, and each neighbor is claimed with an atomic compare-and-swap, so exactly
+    // one thread visits it. When a stack grows past SPLIT_SIZE, its older half becomes a
+    // new task that an idle thread can steal. Nothing recurses per vertex, so long paths
+    // cannot overflow the call stack
     void parallelDFS(int startVertex) {
-        vector<bool> visited(V, false);
-        parallelDFSUtil(startVertex, visited);
+        vector<char> visited(V, 0);
+        visited[startVertex] = 1;
+
+        #pragma omp parallel
+        #pragma omp single
+        parallelDFSTask(vector<int>(1, startVertex), visited);
     }
 
-    // Parallel DFS utility function
-    void parallelDFSUtil(int v, vector<bool>& visited) {
-        visited[v] = true;
-        cout << v << " ";
+    // Runs one task's stack until it is empty; the single's barrier waits for all tasks
+    void parallelDFSTask(vector<int> stack, vector<char>& visited) {
+        const size_t SPLIT_SIZE = 64;
 
-        #pragma omp parallel for
-        for (int i = 0; i < adj[v].size(); ++i) {
-            int n = adj[v][i];
-            if (!visited[n])
-                parallelDFSUtil(n, visited);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            #pragma omp critical(dfs_print)
+            cout << v << " ";
+
+            // Reverse order, so the first neighbor is popped first
+            for (int i = (int)adj[v].size() - 1; i >= 0; i--) {
+                int n = adj[v][i];
+                char unvisited = 0;
+                if (__atomic_compare_exchange_n(&visited[n], &unvisited, 1, false,
+                                                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                    stack.push_back(n);
+            }
+
+            if (stack.size() > SPLIT_SIZE) {
+                vector<int> older(stack.begin(), stack.begin() + stack.size() / 2);
+                stack.erase(stack.begin(), stack.begin() + older.size());
+                #pragma omp task firstprivate(older) shared(visited)
+                parallelDFSTask(older, visited);
+            }
         }
     }
 
@@ -88,6 +142,10 @@ g.addEdge(1, 4);
     */
 
     cout << "Depth-First Search (DFS): ";
+    g.DFS(0);
+    cout << endl;
+
+    cout << "Parallel Depth-First Search: ";
     g.parallelDFS(0);
     cout << endl;
 
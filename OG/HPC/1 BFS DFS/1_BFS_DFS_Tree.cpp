@@ -1,111 +1,311 @@
 #include <iostream>
 #include <vector>
-#include <queue>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
 #include <omp.h>
 
 using namespace std;
 
-// Node structure representing a tree node
-struct TreeNode {
-    int data;
-    vector<TreeNode*> children;
+// Below this many items a loop runs on one thread; forking a team costs more
+const int PARALLEL_CUTOFF = 4096;
 
-    TreeNode(int val) : data(val) {}
-};
+// In-place exclusive prefix sum of a[0 .. n); returns the total.
+// Each thread scans its own block, then adds the sum of the blocks before it.
+long long exclusiveScan(int* a, int n) {
+    if (n <= PARALLEL_CUTOFF) {
+        long long sum = 0;
+        for (int i = 0; i < n; i++) {
+            int x = a[i];
+            a[i] = (int)sum;
+            sum += x;
+        }
+        return sum;
+    }
 
-// Tree class representing the tree structure
-class Tree {
-    TreeNode* root;
+    int nthreads = omp_get_max_threads();
+    vector<long long> blockSum(nthreads + 1, 0);
+    int used = nthreads;  // the runtime may give a smaller team (OMP_DYNAMIC)
 
-public:
-    Tree(int val) {
-        root = new TreeNode(val);
-    }
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int t = omp_get_thread_num(), team = omp_get_num_threads();
+        #pragma omp single
+        used = team;
+
+        int lo = (int)((long long)n * t / team), hi = (int)((long long)n * (t + 1) / team);
 
-    void addChild(TreeNode* parent, int val) {
-        TreeNode* newNode = new TreeNode(val);
-        parent->children.push_back(newNode);
+        long long sum = 0;
+        for (int i = lo; i < hi; i++) {
+            int x = a[i];
+            a[i] = (int)sum;
+            sum += x;
+        }
+        blockSum[t + 1] = sum;
+
+        #pragma omp barrier
+        #pragma omp single
+        for (int i = 0; i < team; i++)
+            blockSum[i + 1] += blockSum[i];
+
+        for (int i = lo; i < hi; i++)
+            a[i] += (int)blockSum[t];
     }
+    return blockSum[used];
+}
+
+// Flat tree in structure-of-arrays form. Nodes are numbered 0 .. n-1 and all three
+// arrays live in one arena allocation (12 bytes per node, no per-node new):
+//   parent[v]                                     parent of v, -1 for the root
+//   children[firstChild[v] .. firstChild[v + 1])  children of v, in increasing id order
+class FlatTree {
+    int n;
+    int root;
+    unique_ptr<int[]> arena;  // parent | firstChild | children
+    int* parentOf;
+    int* firstChild;
+    int* children;
+
+public:
+    // parent[] must describe one tree: exactly one -1 (the root), no cycles
+    FlatTree(const int* parent, int count)
+        : n(count), root(-1), arena(new int[3 * (size_t)count + 1]) {
+        parentOf = arena.get();
+        firstChild = parentOf + n;
+        children = firstChild + n + 1;
+
+        // Count the children of p into firstChild[p + 1]
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int v = 0; v <= n; v++)
+            firstChild[v] = 0;
+
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int v = 0; v < n; v++) {
+            int p = parent[v];
+            parentOf[v] = p;
+            if (p < 0)
+                root = v;
+            else
+                __atomic_fetch_add(&firstChild[p + 1], 1, __ATOMIC_RELAXED);
+        }
+
+        // After the scan firstChild[p + 1] is the start of p's segment; every child then
+        // bumps it by one, which leaves it at the end of p's segment = start of p + 1's
+        exclusiveScan(firstChild + 1, n);
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int v = 0; v < n; v++) {
+            int p = parentOf[v];
+            if (p >= 0)
+                children[__atomic_fetch_add(&firstChild[p + 1], 1, __ATOMIC_RELAXED)] = v;
+        }
 
-    TreeNode* getRoot() {
-        return root;
+        // The atomic scatter leaves siblings in any order; sort them for a fixed traversal order
+        #pragma omp parallel for schedule(dynamic, 1024) if(n > PARALLEL_CUTOFF)
+        for (int v = 0; v < n; v++)
+            if (firstChild[v + 1] - firstChild[v] > 1)
+                sort(children + firstChild[v], children + firstChild[v + 1]);
     }
 
-    // ✅ Parallel DFS using OpenMP tasks
-    void parallelDFS(TreeNode* node) {
-        if (!node) return;
+    int size() const { return n; }
+    int getRoot() const { return root; }
+    int parent(int v) const { return parentOf[v]; }
+    int numChildren(int v) const { return firstChild[v + 1] - firstChild[v]; }
+    const int* childrenBegin(int v) const { return children + firstChild[v]; }
+    const int* childrenEnd(int v) const { return children + firstChild[v + 1]; }
+    size_t memoryBytes() const { return (3 * (size_t)n + 1) * sizeof(int); }
 
-        cout << node->data << " ";
+    // Level-order traversal without locks. The children of a node are one contiguous
+    // range, so the next level is the concatenation of the frontier's child ranges:
+    // a prefix sum over the child counts gives every frontier node its output slot.
+    // order[levelStart[d] .. levelStart[d + 1]) is level d.
+    void levelOrder(vector<int>& order, vector<int>& levelStart) const {
+        order.resize(n);
+        levelStart.assign(1, 0);
+        if (n == 0)
+            return;
 
-        #pragma omp parallel
-        {
-            #pragma omp single nowait
-            {
-                for (TreeNode* child : node->children) {
-                    #pragma omp task firstprivate(child)
-                    parallelDFS(child);
-                }
+        vector<int> slot;
+        order[0] = root;
+        int head = 0, tail = 1;
+
+        while (head < tail) {
+            int width = tail - head;
+            slot.resize(width + 1);
+
+            #pragma omp parallel for if(width > PARALLEL_CUTOFF)
+            for (int i = 0; i < width; i++)
+                slot[i] = numChildren(order[head + i]);
+            slot[width] = 0;
+            int next = (int)exclusiveScan(slot.data(), width + 1);
+
+            #pragma omp parallel for schedule(dynamic, 256) if(width > PARALLEL_CUTOFF)
+            for (int i = 0; i < width; i++) {
+                int u = order[head + i];
+                copy(childrenBegin(u), childrenEnd(u), order.begin() + tail + slot[i]);
             }
+
+            levelStart.push_back(tail);
+            head = tail;
+            tail += next;
         }
     }
 
-    // ✅ Parallel BFS using level-by-level OpenMP parallelism
-    void parallelBFS() {
-        if (!root) return;
-
-        queue<TreeNode*> q;
-        q.push(root);
-
-        while (!q.empty()) {
-            int levelSize = q.size();
-            vector<TreeNode*> nextLevel;
-
-            #pragma omp parallel for
-            for (int i = 0; i < levelSize; ++i) {
-                TreeNode* current;
-
-                // Synchronize access to the queue
-                #pragma omp critical
-                {
-                    current = q.front();
-                    q.pop();
-                }
-
-                #pragma omp critical
-                cout << current->data << " ";
-
-                // Save children for next level (synchronized)
-                #pragma omp critical
-                {
-                    for (TreeNode* child : current->children) {
-                        nextLevel.push_back(child);
-                    }
-                }
-            }
+    // Euler tour: preorder number, subtree size and depth of every node, without
+    // recursion (no stack overflow on path-like trees) and in O(n) work.
+    // The tour walks every tree edge twice: arc c enters child c, arc n + c leaves it.
+    //  1. next[] links every arc to its successor in the tour (one parallel pass over
+    //     the children array).
+    //  2. List ranking: the list is cut at a few hundred arcs per thread, every piece is
+    //     walked by one thread, the pieces are chained in order, and every arc gets
+    //     rank = offset of its piece + position inside it.
+    //  3. The arcs are laid out by rank and a prefix sum counts the "enter" arcs.
+    //     For a node c entered at position k and left at position k':
+    //       preorder[c]    = enters up to k
+    //       depth[c]       = enters up to k - leaves up to k
+    //       subtreeSize[c] = enters in (k, k'] + 1
+    // The result is exactly the sequential recursive preorder (children in id order).
+    void eulerTour(vector<int>& preorder, vector<int>& subtreeSize, vector<int>& depth) const {
+        preorder.assign(n, 0);
+        subtreeSize.assign(n, 1);
+        depth.assign(n, 0);
+        if (n == 0)
+            return;
+        subtreeSize[root] = n;
+        if (n == 1)
+            return;
+
+        int m = 2 * (n - 1);               // arcs in the tour
+        vector<int> next(2 * n, -1);       // arc ids c and n + c; the root's two slots stay unused
+        vector<int> rank(2 * n), piece(2 * n, -1);
 
-            // Push all next level nodes into the queue
-            for (TreeNode* node : nextLevel) {
-                q.push(node);
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int k = 0; k < n - 1; k++) {
+            int c = children[k], p = parentOf[c];
+            next[c] = numChildren(c) > 0 ? children[firstChild[c]] : n + c;
+            if (k + 1 < firstChild[p + 1])
+                next[n + c] = children[k + 1];
+            else
+                next[n + c] = p == root ? -1 : n + p;
+        }
+
+        // Piece heads: the first arc of the tour plus arcs spread evenly over the ids
+        int first = children[firstChild[root]];
+        int wanted = min(m, 256 * omp_get_max_threads());
+        vector<int> head(1, first);
+        piece[first] = 0;
+        for (int i = 1; i < wanted; i++) {
+            int x = (int)((long long)2 * n * i / wanted);
+            if (x == root || x == n + root || piece[x] >= 0)
+                continue;
+            piece[x] = (int)head.size();
+            head.push_back(x);
+        }
+
+        int pieces = (int)head.size();
+        vector<int> length(pieces), after(pieces), offset(pieces);
+
+        // Walk every piece until the next head; only heads have piece[] set beforehand
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int s = 0; s < pieces; s++) {
+            int x = head[s], steps = 1;
+            rank[x] = 0;
+            for (x = next[x]; x >= 0 && piece[x] < 0; x = next[x]) {
+                piece[x] = s;
+                rank[x] = steps++;
             }
+            length[s] = steps;
+            after[s] = x < 0 ? -1 : piece[x];
+        }
+
+        // Chain the pieces in tour order (one entry per piece, so this loop is short)
+        for (int s = 0, sum = 0; s >= 0; s = after[s]) {
+            offset[s] = sum;
+            sum += length[s];
+        }
+
+        // Final ranks, then every position of the tour gets 1 for "enter", 0 for "leave"
+        vector<int>& enters = next;  // next[] is no longer needed; reuse its memory
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int x = 0; x < 2 * n; x++) {
+            if (x == root || x == n + root)
+                continue;
+            rank[x] += offset[piece[x]];
+        }
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int x = 0; x < 2 * n; x++) {
+            if (x == root || x == n + root)
+                continue;
+            enters[rank[x]] = x < n;
+        }
+        exclusiveScan(enters.data(), m);  // enters[k] = "enter" arcs before position k
+
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int c = 0; c < n; c++) {
+            if (c == root)
+                continue;
+            int k = rank[c], kLeave = rank[n + c];
+            int entered = enters[k] + 1;
+            preorder[c] = entered;
+            depth[c] = 2 * entered - (k + 1);
+            subtreeSize[c] = enters[kLeave] - enters[k];
         }
     }
+
+    // Depth-first preorder: every node writes itself to its Euler-tour preorder slot
+    void depthFirstOrder(vector<int>& order) const {
+        vector<int> preorder, subtreeSize, depth;
+        eulerTour(preorder, subtreeSize, depth);
+        order.resize(n);
+
+        #pragma omp parallel for if(n > PARALLEL_CUTOFF)
+        for (int v = 0; v < n; v++)
+            order[preorder[v]] = v;
+    }
 };
 
-int main() {
-    // Build the tree
-    Tree tree(1);
-    TreeNode* root = tree.getRoot();
-    tree.addChild(root, 2);
-    tree.addChild(root, 3);
-    tree.addChild(root, 4);
+// Traversals only fill arrays; printing is a separate pass
+void printNodes(const vector<int>& order, const vector<int>& label) {
+    string out;
+    for (int v : order)
+        out += to_string(label[v]) + " ";
+    cout << out;
+}
+
+int main(int argc, char* argv[]) {
+    // Large run: ./1_BFS_DFS_Tree n  builds a random tree of n nodes and times both traversals
+    if (argc > 1) {
+        int n = atoi(argv[1]);
+        if (n < 1) {
+            cout << "Number of nodes must be positive" << endl;
+            return 1;
+        }
+
+        vector<int> parent(n);
+        parent[0] = -1;
+        #pragma omp parallel for
+        for (int v = 1; v < n; v++) {
+            unsigned long long x = (unsigned long long)v * 0x9E3779B97F4A7C15ULL;
+            x ^= x >> 31;
+            parent[v] = (int)(x % v);  // random earlier node: a random recursive tree
+        }
+
+        double t0 = omp_get_wtime();
+        FlatTree tree(parent.data(), n);
+        double built = omp_get_wtime();
+        vector<int>().swap(parent);
 
-    TreeNode* node2 = root->children[0];
-    tree.addChild(node2, 5);
-    tree.addChild(node2, 6);
+        vector<int> order, levelStart, preorder, subtreeSize, depth;
+        tree.levelOrder(order, levelStart);
+        double bfsDone = omp_get_wtime();
+        tree.eulerTour(preorder, subtreeSize, depth);
+        double tourDone = omp_get_wtime();
 
-    TreeNode* node4 = root->children[2];
-    tree.addChild(node4, 7);
-    tree.addChild(node4, 8);
+        cout << "Tree of " << n << " nodes, " << tree.memoryBytes() / 1048576.0 << " MB, "
+             << levelStart.size() - 1 << " levels" << endl;
+        cout << "Build: " << built - t0 << " s, BFS: " << bfsDone - built
+             << " s, Euler tour (preorder, subtree sizes, depths): " << tourDone - bfsDone << " s" << endl;
+        return 0;
+    }
 
     /*
                1
@@ -114,14 +314,27 @@ int main() {
            / \    / \
           5   6  7   8
     */
+    // Node v carries the label v + 1; the tree is given by its parent array
+    vector<int> parent = {-1, 0, 0, 0, 1, 1, 3, 3};
+    vector<int> label = {1, 2, 3, 4, 5, 6, 7, 8};
+    FlatTree tree(parent.data(), (int)parent.size());
+
+    vector<int> order, levelStart, preorder, subtreeSize, depth;
 
     cout << "Parallel Depth-First Search (DFS): ";
-    tree.parallelDFS(root);
+    tree.depthFirstOrder(order);
+    printNodes(order, label);
     cout << endl;
 
     cout << "Parallel Breadth-First Search (BFS): ";
-    tree.parallelBFS();
+    tree.levelOrder(order, levelStart);
+    printNodes(order, label);
     cout << endl;
 
+    cout << "Euler tour (node: preorder, subtree size, depth):" << endl;
+    tree.eulerTour(preorder, subtreeSize, depth);
+    for (int v = 0; v < tree.size(); v++)
+        cout << "  " << label[v] << ": " << preorder[v] << ", " << subtreeSize[v] << ", " << depth[v] << endl;
+
     return 0;
 }
@@ -1,77 +1,78 @@
 #include <iostream>
+#include <vector>
 #include <omp.h>
 
 using namespace std;
 
-void merge(int arr[], int low, int mid, int high) {
-    // Create arrays of left and right partitions
-    int n1 = mid - low + 1;
-    int n2 = high - mid;
-
-    int left[n1];
-    int right[n2];
-
-    // Copy all left elements
-    for (int i = 0; i < n1; i++) left[i] = arr[low + i];
-
-    // Copy all right elements
-    for (int j = 0; j < n2; j++) right[j] = arr[mid + 1 + j];
+// Merges arr[low..mid] and arr[mid+1..high] through temp, a buffer as large as arr
+// that is allocated once by the caller (stack arrays of n elements overflow for large n)
+void merge(int arr[], int temp[], int low, int mid, int high) {
+    // Copy both partitions to the same positions in temp
+    for (int i = low; i <= high; i++) temp[i] = arr[i];
 
     // Compare and place elements
-    int i = 0, j = 0, k = low;
+    int i = low, j = mid + 1, k = low;
 
-    while (i < n1 && j < n2) {
-        if (left[i] <= right[j]) {
-            arr[k] = left[i];
+    while (i <= mid && j <= high) {
+        if (temp[i] <= temp[j]) {
+            arr[k] = temp[i];
             i++;
         } else {
-            arr[k] = right[j];
+            arr[k] = temp[j];
             j++;
         }
         k++;
     }
 
-    // If any elements are left in left array
-    while (i < n1) {
-        arr[k] = left[i];
+    // If any elements are left in left partition
+    while (i <= mid) {
+        arr[k] = temp[i];
         i++;
         k++;
     }
 
-    // If any elements are left in right array
-    while (j < n2) {
-        arr[k] = right[j];
+    // If any elements are left in right partition
+    while (j <= high) {
+        arr[k] = temp[j];
         j++;
         k++;
     }
 }
 
-void parallelMergeSort(int arr[], int low, int high) {
+void mergeSort(int arr[], int temp[], int low, int high) {
     if (low < high) {
-        int mid = (low + high) / 2;
-
-        #pragma omp parallel sections
-        {
-            #pragma omp section
-            {
-                parallelMergeSort(arr, low, mid);
-            }
-
-            #pragma omp section
-            {
-                parallelMergeSort(arr, mid + 1, high);
-            }
-        }
-        merge(arr, low, mid, high);
+        int mid = low + (high - low) / 2;
+        mergeSort(arr, temp, low, mid);
+        mergeSort(arr, temp, mid + 1, high);
+        merge(arr, temp, low, mid, high);
     }
 }
 
-void mergeSort(int arr[], int low, int high) {
-    if (low < high) {
-        int mid = (low + high) / 2;
-        mergeSort(arr, low, mid);
-        mergeSort(arr, mid + 1, high);
-        merge(arr, low, mid, high);
+// Ranges smaller than this are sorted sequentially instead of creating more tasks
+const int TASK_CUTOFF = 10000;
+
+void parallelMergeSortTask(int arr[], int temp[], int low, int high) {
+    if (high - low < TASK_CUTOFF) {
+        mergeSort(arr, temp, low, high);
+        return;
+    }
+    int mid = low + (high - low) / 2;
+
+    #pragma omp task
+    parallelMergeSortTask(arr, temp, low, mid);
+
+    parallelMergeSortTask(arr, temp, mid + 1, high);
+
+    #pragma omp taskwait
+    merge(arr, temp, low, mid, high);
+}
+
+// One parallel region for the whole sort; the recursion spawns tasks inside it
+void parallelMergeSort(int arr[], int temp[], int low, int high) {
+    #pragma omp parallel
+    {
+        #pragma omp single
+        parallelMergeSortTask(arr, temp, low, high);
     }
 }
 
@@ -85,7 +86,8 @@ void printArray(int arr[], int n) {
 
 int main() {
     int n = 10;
-    int arr[n];
+    vector<int> numbers(n), buffer(n);
+    int *arr = numbers.data(), *temp = buffer.data();
     double start_time, end_time;
 
     // Create an array with numbers starting from n to 1
@@ -93,7 +95,7 @@ int main() {
 
     // Measure Sequential Time
     start_time = omp_get_wtime();
-    mergeSort(arr, 0, n - 1);
+    mergeSort(arr, temp, 0, n - 1);
     end_time = omp_get_wtime();
     cout << "Time taken by sequential algorithm: " << end_time - start_time << " seconds\n";
 
@@ -106,7 +108,7 @@ int main() {
 
     // Measure Parallel Time
     start_time = omp_get_wtime();
-    parallelMergeSort(arr, 0, n - 1);
+    parallelMergeSort(arr, temp, 0, n - 1);
     end_time = omp_get_wtime();
     cout << "Time taken by parallel algorithm: " << end_time - start_time << " seconds\n";
 
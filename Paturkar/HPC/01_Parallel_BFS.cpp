@@ -9,69 +9,74 @@
  *    (if above not worked): g++ 01_Parallel_BFS.cpp -o 01_Parallel_BFS
  *    (General command): g++ -fopenmp fileName.cpp -o fileName or g++ fileName.cpp -o fileName
  * 3. Run: ./01_Parallel_BFS or .\01_Parallel_BFS
+ *    Large graphs: ./01_Parallel_BFS graph.csr (binary snapshot made by graph_convert.cpp)
+ *    Renumbered:   ./01_Parallel_BFS graph.csr rcm (or degree / bfs, see reorder.h)
+ *    Timing only:  ./01_Parallel_BFS graph.csr --quiet
  */
 
 #include <iostream>
 #include <vector>
-#include <queue>
+#include <cstring>
 #include <omp.h>
+#include "graph.h"
+#include "bfs.h"
+#include "reorder.h"
+#include "components.h"
+#include "writer.h"
 
 using namespace std;
 
-struct Graph
+// Traversal and output are separate steps: levelSyncBFS() only fills r,
+// writeVertexList() prints the visit order in one buffered pass
+void BFS(const Graph &g, int start)
 {
-    int V;
-    vector<vector<int>> adj;
-
-    Graph(int V)
-    {
-        this->V = V;
-        adj.resize(V);
-    }
-
-    void addEdge(int u, int v)
-    {
-        adj[u].push_back(v);
-        adj[v].push_back(u); // Undirected graph
-    }
+    BFSResult r = levelSyncBFS(g, start);
+    writeVertexList(stdout, r.order);
+}
 
-    void BFS(int start)
+int main(int argc, char *argv[])
+{
+    // Binary snapshot mode: ./01_Parallel_BFS graph.csr [original|degree|rcm|bfs] [--quiet]
+    // (see graph_convert.cpp); the optional ordering renumbers vertices for locality,
+    // --quiet skips printing the visit order
+    if (argc > 1)
     {
-        vector<bool> visited(V, false);
-        queue<int> q;
-
-        visited[start] = true;
-        q.push(start);
-
-        while (!q.empty())
+        Graph g;
+        if (!loadSnapshot(argv[1], g))
         {
-            int u = q.front();
-            q.pop();
-            cout << u << " ";
-
-#pragma omp parallel for
-            for (int i = 0; i < adj[u].size(); i++)
+            cout << "Could not load snapshot " << argv[1] << endl;
+            return 1;
+        }
+        Ordering ordering = Ordering::Original;
+        bool quiet = false;
+        for (int i = 2; i < argc; i++)
+        {
+            if (strcmp(argv[i], "--quiet") == 0)
+                quiet = true;
+            else if (!parseOrdering(argv[i], ordering))
             {
-                int v = adj[u][i];
-                if (!visited[v])
-                {
-#pragma omp critical
-                    {
-                        if (!visited[v])
-                        { // Double check inside critical
-                            visited[v] = true;
-                            q.push(v);
-                        }
-                    }
-                }
+                cout << "Unknown option " << argv[i] << " (use original, degree, rcm, bfs or --quiet)" << endl;
+                return 1;
             }
         }
-        cout << endl;
+        cout << "Loaded " << g.V << " vertices and " << g.numEdges() / 2 << " edges" << endl;
+        if (g.V == 0)
+            return 0; // nothing to traverse
+
+        Reordering ro = reorder(g, ordering);
+        BFSResult r;
+        double start = omp_get_wtime();
+        levelSyncBFS(ro.graph, ro.newId[0], r);
+        double elapsed = omp_get_wtime() - start;
+        r = toOriginalIds(ro, r);
+
+        cout << "Parallel BFS (" << orderingName(ordering) << " ordering): reached " << r.order.size()
+             << " vertices in " << r.levelStart.size() - 1 << " levels, " << elapsed << " s" << endl;
+        if (!quiet)
+            writeVertexList(stdout, r.order);
+        return 0;
     }
-};
 
-int main()
-{
     // Example 1: Small graph for basic understanding
     cout << "Example 1: Small Graph (5 vertices)\n";
     Graph g1(5);
@@ -79,8 +84,9 @@ int main()
     g1.addEdge(0, 2);
     g1.addEdge(1, 3);
     g1.addEdge(2, 4);
+    g1.build();
     cout << "BFS traversal starting from vertex 0: ";
-    g1.BFS(0);
+    BFS(g1, 0);
     cout << "\n";
 
     // Example 2: Slightly larger graph
@@ -92,8 +98,9 @@ int main()
     g2.addEdge(2, 4);
     g2.addEdge(3, 5);
     g2.addEdge(4, 6);
+    g2.build();
     cout << "BFS traversal starting from vertex 0: ";
-    g2.BFS(0);
+    BFS(g2, 0);
 
     cout << "\n";
 
@@ -101,6 +108,11 @@ int main()
     int V;
     cout << "Enter the number of vertices: ";
     cin >> V;
+    if (!cin || V <= 0)
+    {
+        cout << "The graph needs at least one vertex to start from" << endl;
+        return 0;
+    }
 
     Graph g(V);
 
@@ -115,9 +127,30 @@ int main()
         cin >> u >> v;
         g.addEdge(u, v);
     }
+    g.build();
 
     cout << "Parallel BFS traversal:" << endl;
-    g.BFS(0);
+    BFS(g, 0);
+
+    BFSResult r = directionOptimizingBFS(g, 0);
+    cout << "Direction-optimizing BFS, direction per level (T = top-down, B = bottom-up): ";
+    for (char d : r.direction)
+        cout << d << " ";
+    cout << endl;
+
+    // Batched BFS from several sources at once (one adjacency sweep per level for all)
+    vector<int> sources;
+    for (int s = 0; s < V && s < 4; s++)
+        sources.push_back(s);
+    MultiSourceBFSResult ms = multiSourceBFS(g, sources, false);
+    cout << "Sum of distances from vertices 0.." << sources.size() - 1 << " to each vertex: ";
+    for (int v = 0; v < V; v++)
+        cout << ms.distSum[v] << " ";
+    cout << endl;
+
+    ComponentsResult cc = connectedComponents(g);
+    cout << "Connected components: " << cc.numComponents << ", largest has "
+         << (cc.largest >= 0 ? cc.size[cc.largest] : 0) << " vertices" << endl;
 
     return 0;
 }
@@ -136,27 +169,29 @@ int main()
  * ----------------
  * 1. OpenMP (#pragma omp)
  *    - A parallel programming API for shared-memory multiprocessing
- *    - Used here for parallel task execution and thread management
+ *    - Used here for one parallel region per BFS, shared by all its levels
  *    - Examples in other contexts: parallel for loops, matrix multiplication
  *    - Directives used:
  *      #pragma omp parallel      // Creates parallel region with multiple threads
- *      #pragma omp single nowait // Single thread executes, others don't wait
- *      #pragma omp task          // Creates new task for parallel execution
- *      #pragma omp parallel for  // Distributes loop iterations among threads
+ *      #pragma omp for           // Splits the frontier of one level among the threads
+ *      #pragma omp single        // One thread does the prefix sum over buffer sizes
+ *      #pragma omp barrier       // Ends a level: all discoveries are in place
  *
  * 2. STL Containers
  *    - vector<>: Dynamic arrays for adjacency lists
- *    - queue<>: FIFO data structure for BFS traversal
+ *    - order[]: Visit order array that doubles as the level-by-level frontier queue
  *
  * Data Structures:
  * ---------------
- * 1. Graph (struct)
- *    - Adjacency list representation using vector<vector<int>>
+ * 1. Graph (struct, graph.h)
+ *    - Compressed Sparse Row (CSR): one offsets[V+1] array and one neighbors[2E] array
+ *    - Built in bulk from the edges passed to addEdge() when build() is called
  *    - Allows O(1) access to vertices and O(degree) traversal of neighbors
  *
- * 2. BFS-specific structures:
- *    - visited[]: Boolean array tracking visited vertices
- *    - queue: Maintains vertices to be explored
+ * 2. BFS-specific structures (bfs.h):
+ *    - visited: Atomic bitmap, one bit per vertex, claimed with compare-and-swap
+ *    - Per-thread discovery buffers, concatenated with a prefix sum after each level
+ *    - level[] / parent[]: Distance from the start vertex and BFS tree parent
  *
  * Complexity Analysis:
  * -------------------
@@ -165,12 +200,12 @@ int main()
  * - Parallel: O((V + E)/p) theoretical, where p = number of processors
  *
  * Space Complexity:
- * - O(V + E) for adjacency list
- * - O(V) for visited array and queue
+ * - O(V + E) for the CSR arrays: 8(V+1) bytes of offsets + 4*2E bytes of neighbors
+ * - O(V) for the visited bitmap, level, parent and order arrays
  *
  * Parallel Performance Factors:
  * ---------------------------
- * 1. Critical Section Overhead
+ * 1. Barrier Cost per Level (high-diameter graphs have many small levels)
  * 2. Load Balancing
  * 3. Graph Structure/Density
  * 4. Memory Access Patterns
@@ -191,77 +226,106 @@ int main()
  * A3: It distributes loop iterations across multiple threads, enabling parallel
  *     processing of independent operations.
  *
- * Q4: Why is the critical section necessary?
- * A4: To prevent race conditions when multiple threads try to update shared data
- *     (visited array and queue) simultaneously.
+ * Q4: Why is no critical section needed?
+ * A4: Each thread claims a vertex by atomically setting its bit in the visited bitmap.
+ *     Only the thread whose compare-and-swap sets the bit records the vertex, and it
+ *     writes to its own buffer, so there is no shared queue to protect.
  *
- * Q5: What's the purpose of double-checking visited[v]?
- * A5: It's a performance optimization that reduces critical section contention
- *     by checking visited status before entering the critical section.
+ * Q5: What's the purpose of testing visited before claiming?
+ * A5: It's a plain read that skips the atomic operation for vertices that are
+ *     already visited, which is the common case in the middle levels.
  *
  * Q6: How does parallel BFS differ from sequential BFS?
- * A6: Parallel BFS processes multiple neighbors concurrently, but requires
- *     synchronization for shared data access.
+ * A6: Level-synchronous BFS expands the whole frontier in parallel and only
+ *     synchronizes at the end of each level, when the per-thread buffers are
+ *     placed one after another using a prefix sum of their sizes.
  *
  * Q7: What factors affect parallel performance?
  * A7: Graph structure, thread overhead, memory access patterns, load balancing,
- *     and critical section contention.
+ *     and the number of levels (one barrier each).
+ *
+ * Q8: What is direction-optimizing BFS?
+ * A8: In the middle levels of low-diameter graphs most edges lead to vertices that
+ *     are already visited. Switching to bottom-up there (every unvisited vertex looks
+ *     for one parent in the frontier and stops at the first hit) skips most of those
+ *     edges. The switch is made when the frontier's edges exceed 1/alpha of the
+ *     unexplored edges, and undone when the frontier shrinks below V/beta vertices.
+ *
+ * Q9: How does multi-source BFS (MS-BFS) save work?
+ * A9: Each vertex carries a "seen-by" bitset with one bit per source. A level ORs
+ *     the bitsets of a vertex's neighbors, so one scan of the adjacency arrays
+ *     advances up to 256 searches at once instead of rescanning the graph per source.
  *
- * Q8: Why use vector<bool> for visited array?
- * A8: It's space-efficient as it typically uses 1 bit per boolean instead of
- *     1 byte, though it may have performance tradeoffs.
+ * Q10: Why use a bitmap for the visited array?
+ * A10: It's space-efficient (1 bit per vertex), so more of it stays in cache, and
+ *      64-bit words can be updated atomically, unlike vector<bool>.
  *
- * Q9: How does load balancing affect performance?
- * A9: Uneven distribution of edges among vertices can lead to some threads
- *     doing more work than others, reducing parallel efficiency.
+ * Q11: How does load balancing affect performance?
+ * A11: Uneven distribution of edges among vertices can lead to some threads
+ *      doing more work than others, reducing parallel efficiency. The frontier is
+ *      handed out in chunks of 64 vertices (schedule(dynamic, 64)) so that threads
+ *      that finish early take more.
  *
- * Q10: What's the impact of graph density on performance?
- * A10: Denser graphs have more edges to process but may suffer from increased
- *      critical section contention.
+ * Q12: What's the impact of graph density on performance?
+ * A12: Denser graphs have more edges to process, and more of them point at the same
+ *      vertices, so more compare-and-swap attempts on the bitmap fail or contend for
+ *      the same 64-bit word. The plain test before the claim skips most of them.
  *
- * Q11: How can we optimize the parallel implementation?
- * A11: Use larger grain sizes, minimize critical sections, employ better
- *      load balancing, and consider graph partitioning.
+ * Q13: How can we optimize the parallel implementation?
+ * A13: Use larger grain sizes, keep atomic claims off already visited vertices,
+ *      switch to bottom-up on large frontiers, employ better load balancing,
+ *      renumber vertices for locality, and consider graph partitioning.
  *
- * Q12: What's the significance of the queue in BFS?
- * A12: The queue maintains the FIFO order necessary for level-by-level
- *      traversal characteristic of BFS.
+ * Q14: How is the next frontier built without a shared queue?
+ * A14: Every thread appends its claimed vertices to a private buffer. At the end of
+ *      the level one thread takes a prefix sum over the buffer sizes, which gives
+ *      every thread its own slice of order[] to copy into. The slices follow each
+ *      other, so order[] holds the levels one after another: it is the FIFO order
+ *      of a queue-based BFS level by level, without any locking.
  *
- * Q13: How does thread count affect performance?
- * A13: More threads can improve performance up to a point, after which
+ * Q15: How does thread count affect performance?
+ * A15: More threads can improve performance up to a point, after which
  *      overhead and contention may degrade performance.
  *
- * Q14: Why is the graph undirected?
- * A14: Each edge is bidirectional (u->v and v->u), suitable for applications
+ * Q16: Why is the graph undirected?
+ * A16: Each edge is bidirectional (u->v and v->u), suitable for applications
  *      like social networks or road systems.
  *
- * Q15: What are the memory access patterns in this implementation?
- * A15: Random access patterns when accessing adjacency lists and visited array,
- *      which can affect cache performance.
+ * Q17: What are the memory access patterns in this implementation?
+ * A17: Random access patterns when accessing adjacency lists and visited array,
+ *      which can affect cache performance. Renumbering the vertices once at load
+ *      time (reorder.h: degree, rcm or bfs ordering) keeps vertices that are visited
+ *      together close in memory; reorder_report.cpp measures the gain on a graph.
  *
- * Q16: What are the limitations of this implementation?
- * A16: - No handling of disconnected components
+ * Q18: What are the limitations of this implementation?
+ * A18: - BFS reaches only the start vertex's component; connectedComponents()
+ *        (components.h, parallel union-find) labels all components at once
  *      - Potential overhead for small graphs
- *      - Memory contention in dense graphs
+ *      - One barrier per level, which dominates on high-diameter graphs
  *
- * Q17: What is the purpose of #pragma omp critical?
- * A17: Ensures mutual exclusion, allowing only one thread to execute a code block at a time,
- *      preventing race conditions in shared resource access.
+ * Q19: How does the compare-and-swap claim work?
+ * A19: __atomic_compare_exchange_n writes old | mask into the bitmap word only if
+ *      the word still equals old, and reports whether it did. If another thread
+ *      changed the word in between, old is refreshed and the loop retries until
+ *      either this thread sets the bit or sees it already set, so exactly one thread
+ *      claims each vertex.
  *
- * Q18: How does #pragma omp taskwait work in OpenMP?
- * A18: Forces the current thread to wait until all its child tasks complete,
- *      useful for synchronization points in the algorithm.
+ * Q20: Why is a barrier enough between levels, without taskwait or critical?
+ * A20: No tasks are created, so there is nothing to wait for but the other threads.
+ *      The barrier after the copy guarantees every slice of the new frontier is
+ *      written before any thread starts reading it in the next level.
  *
- * Q19: What is the role of OMP_NUM_THREADS environment variable?
- * A19: Sets the default number of threads for parallel regions in OpenMP programs,
+ * Q21: What is the role of OMP_NUM_THREADS environment variable?
+ * A21: Sets the default number of threads for parallel regions in OpenMP programs,
  *      allowing runtime control of parallelism level.
  *
- * Q20: How does #pragma omp atomic differ from critical?
- * A20: Provides faster, hardware-supported atomic operations for simple updates to shared variables,
- *      more efficient than critical sections for single operations.
+ * Q22: How does an atomic compare-and-swap differ from #pragma omp critical?
+ * A22: It is a single hardware instruction on one memory word, so threads claiming
+ *      different vertices never wait for each other; a critical section would
+ *      serialize every claim in the program.
  *
- * Q21: What is the purpose of #pragma omp barrier?
- * A21: Creates a synchronization point where all threads in a parallel region must wait
+ * Q23: What is the purpose of #pragma omp barrier?
+ * A23: Creates a synchronization point where all threads in a parallel region must wait
  *      before any can proceed, ensuring coordinated execution.
  *
  */
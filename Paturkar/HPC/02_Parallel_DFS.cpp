@@ -9,66 +9,82 @@
  *    (if above not worked): g++ 02_Parallel_DFS.cpp -o 02_Parallel_DFS
  *    (General command): g++ -fopenmp fileName.cpp -o fileName or g++ fileName.cpp -o fileName
  * 3. Run: ./02_Parallel_DFS or .\02_Parallel_DFS
+ *    Large graphs: ./02_Parallel_DFS graph.csr (binary snapshot made by graph_convert.cpp)
+ *    Renumbered:   ./02_Parallel_DFS graph.csr rcm (or degree / bfs, see reorder.h)
+ *    Timing only:  ./02_Parallel_DFS graph.csr --quiet
+ *    Sequential:   ./02_Parallel_DFS graph.csr --sequential (exact DFS order, explicit stack)
  */
 
 #include <iostream>
 #include <vector>
+#include <cstring>
 #include <omp.h>
+#include "graph.h"
+#include "dfs.h"
+#include "reorder.h"
+#include "writer.h"
 
 using namespace std;
 
-struct Graph
+// Traversal and output are separate steps: parallelDFS() only fills r,
+// writeVertexList() prints the preorder in one buffered pass
+void DFS(const Graph &g, int start)
 {
-    int V;
-    vector<vector<int>> adj;
-
-    Graph(int V)
-    {
-        this->V = V;
-        adj.resize(V);
-    }
-
-    void addEdge(int u, int v)
-    {
-        adj[u].push_back(v);
-        adj[v].push_back(u); // Undirected graph
-    }
+    DFSResult r = parallelDFS(g, start);
+    writeVertexList(stdout, r.order);
+}
 
-    void DFS(int start)
+int main(int argc, char *argv[])
+{
+    // Binary snapshot mode: ./02_Parallel_DFS graph.csr [original|degree|rcm|bfs] [--quiet]
+    // [--sequential] (see graph_convert.cpp); the optional ordering renumbers vertices for
+    // locality, --quiet skips printing the preorder, --sequential runs sequentialDFS()
+    if (argc > 1)
     {
-        vector<bool> visited(V, false);
-#pragma omp parallel
+        Graph g;
+        if (!loadSnapshot(argv[1], g))
         {
-#pragma omp single nowait
-            {
-                DFSUtil(start, visited);
-            }
+            cout << "Could not load snapshot " << argv[1] << endl;
+            return 1;
         }
-        cout << endl;
-    }
-
-    void DFSUtil(int u, vector<bool> &visited)
-    {
-        visited[u] = true;
-        cout << u << " ";
-
-#pragma omp parallel for
-        for (int i = 0; i < adj[u].size(); i++)
+        Ordering ordering = Ordering::Original;
+        bool quiet = false, sequential = false;
+        for (int i = 2; i < argc; i++)
         {
-            int v = adj[u][i];
-            if (!visited[v])
+            if (strcmp(argv[i], "--quiet") == 0)
+                quiet = true;
+            else if (strcmp(argv[i], "--sequential") == 0)
+                sequential = true;
+            else if (!parseOrdering(argv[i], ordering))
             {
-#pragma omp task
-                {
-                    DFSUtil(v, visited);
-                }
+                cout << "Unknown option " << argv[i]
+                     << " (use original, degree, rcm, bfs, --quiet or --sequential)" << endl;
+                return 1;
             }
         }
+        cout << "Loaded " << g.V << " vertices and " << g.numEdges() / 2 << " edges" << endl;
+        if (g.V == 0)
+            return 0; // nothing to traverse
+
+        Reordering ro = reorder(g, ordering);
+        DFSResult r;
+        DFSVisitor none;
+        double start = omp_get_wtime();
+        if (sequential)
+            sequentialDFS(ro.graph, ro.newId[0], r, none);
+        else
+            parallelDFS(ro.graph, ro.newId[0], r);
+        double elapsed = omp_get_wtime() - start;
+        r = toOriginalIds(ro, r);
+
+        cout << (sequential ? "Sequential" : "Parallel") << " DFS (" << orderingName(ordering)
+             << " ordering): reached " << r.order.size()
+             << " vertices in " << elapsed << " s" << endl;
+        if (!quiet)
+            writeVertexList(stdout, r.order);
+        return 0;
     }
-};
 
-int main()
-{
     // Example 1: Small graph for basic understanding
     cout << "Example 1: Small Graph (5 vertices)\n";
     Graph g1(5);
@@ -76,8 +92,9 @@ int main()
     g1.addEdge(0, 2);
     g1.addEdge(1, 3);
     g1.addEdge(2, 4);
+    g1.build();
     cout << "DFS traversal starting from vertex 0: ";
-    g1.DFS(0);
+    DFS(g1, 0);
     cout << "\n";
 
     // Example 2: Slightly larger graph
@@ -89,8 +106,9 @@ int main()
     g2.addEdge(2, 4);
     g2.addEdge(3, 5);
     g2.addEdge(4, 6);
+    g2.build();
     cout << "DFS traversal starting from vertex 0: ";
-    g2.DFS(0);
+    DFS(g2, 0);
 
     cout << "\n";
 
@@ -98,6 +116,11 @@ int main()
     int V;
     cout << "Enter the number of vertices: ";
     cin >> V;
+    if (!cin || V <= 0)
+    {
+        cout << "The graph needs at least one vertex to start from" << endl;
+        return 0;
+    }
 
     Graph g(V);
 
@@ -112,9 +135,10 @@ int main()
         cin >> u >> v;
         g.addEdge(u, v);
     }
+    g.build();
 
     cout << "Parallel DFS traversal:" << endl;
-    g.DFS(0);
+    DFS(g, 0);
 
     return 0;
 }
@@ -133,19 +157,23 @@ int main()
  * ----------------
  * 1. OpenMP (#pragma omp)
  *    - A parallel programming API for shared-memory multiprocessing
- *    - Used here for parallel task execution and thread management
+ *    - Used here for thread management and per-worker locks
  *    - Examples in other contexts: parallel for loops, matrix multiplication
  *    - Directives used:
- *      #pragma omp parallel      // Creates parallel region with multiple threads
- *      #pragma omp single nowait // Single thread executes, others don't wait
- *      #pragma omp task          // Creates new task for parallel execution
- *      #pragma omp parallel for  // Distributes loop iterations among threads
+ *      #pragma omp parallel      // Creates one team of workers for the whole DFS
+ *      #pragma omp single        // One thread records the team size
+ *      omp_set_lock / omp_unset_lock // Protect a worker's stack against thieves
  *
  * Data Structures:
  * ---------------
- * 1. Graph (struct)
- *    - Adjacency list representation using vector<vector<int>>
- *    - Boolean visited array for tracking traversal
+ * 1. Graph (struct, graph.h)
+ *    - Compressed Sparse Row (CSR): one offsets[V+1] array and one neighbors[2E] array
+ *    - Built in bulk from the edges passed to addEdge() when build() is called
+ *
+ * 2. DFS-specific structures (dfs.h):
+ *    - One explicit stack of (vertex, next edge) frames per worker
+ *    - Atomic visited bitmap, so every vertex is claimed by exactly one worker
+ *    - parent[], discovery[], finish[]: the DFS forest and its timestamps
  *
  * Complexity Analysis:
  * -------------------
@@ -154,9 +182,9 @@ int main()
  * - Parallel DFS: O((V + E)/p) theoretical, where p = number of processors
  *
  * Space Complexity:
- * - O(V) for visited array
- * - O(V + E) for adjacency list
- * - O(V) additional space for recursion stack
+ * - O(V) for visited bitmap, parent, discovery and finish arrays
+ * - O(V + E) for the CSR arrays: 8(V+1) bytes of offsets + 4*2E bytes of neighbors
+ * - O(V) worst case for the explicit stacks (no recursion, so no stack overflow)
  *
  * Parallel Performance Factors:
  * ---------------------------
@@ -170,16 +198,19 @@ int main()
  * Q1: What is the purpose of #pragma omp parallel?
  * A1: Creates a team of threads for parallel execution. Each thread executes the same code.
  *
- * Q2: Why use #pragma omp single nowait?
- * A2: Ensures only one thread starts the initial DFS while others wait for tasks.
- *     'nowait' allows other threads to proceed without synchronization.
+ * Q2: Why not open a parallel region or task in every recursive call?
+ * A2: Nested parallel regions multiply the thread count at every level of the
+ *     recursion, and tasks over a plain vector<bool> can visit a vertex twice.
+ *     Here one team is created once and each worker runs an ordinary loop.
  *
- * Q3: What's the role of #pragma omp task?
- * A3: Creates a new task for parallel execution of DFS subtrees.
- *     Example: #pragma omp task { DFSUtil(v, visited); }
+ * Q3: How does work stealing work here?
+ * A3: A worker with an empty stack locks a random victim's stack and takes its
+ *     bottom half, i.e. the frames closest to the root with the most work left.
+ *     The top frame is never stolen, so the owner can keep scanning it unlocked.
  *
  * Q4: How is thread safety ensured in the visited array?
- * A4: Each vertex is marked visited before spawning tasks, preventing duplicate visits.
+ * A4: A vertex is claimed by an atomic compare-and-swap on its bit in the visited
+ *     bitmap; only the worker that sets the bit discovers the vertex.
  *
  * Q5: Why use adjacency list over adjacency matrix?
  * A5: Better space efficiency (O(V+E) vs O(V²)) and faster traversal for sparse graphs.
@@ -187,22 +218,26 @@ int main()
  * Q6: What's the impact of graph connectivity on parallel performance?
  * A6: Higher connectivity means more potential parallel tasks but also more synchronization overhead.
  *
- * Q7: How does task scheduling work in this implementation?
- * A7: OpenMP runtime schedules tasks dynamically to available threads using a work-stealing algorithm.
+ * Q7: How are finish times correct when subtrees are stolen?
+ * A7: Each vertex counts its own edge scan plus its unfinished children. The last of
+ *     them to complete stamps the finish time and releases the parent, so a parent
+ *     always finishes after all of its children, whichever worker ran them.
  *
- * Q8: What's the purpose of vector<bool> visited?
+ * Q8: What's the purpose of the visited bitmap?
  * A8: Tracks visited vertices to prevent cycles and repeated processing.
  *
  * Q9: Why is the graph undirected in this implementation?
  * A9: addEdge() adds both (u,v) and (v,u), creating symmetric connections.
  *
  * Q10: How could the implementation be optimized further?
- * A10: - Use task cutoff for small subtrees
- *      - Implement cache-friendly vertex numbering
- *      - Add parallel task merging
+ * A10: - Steal only from workers with deep stacks
+ *      - Implement cache-friendly vertex numbering (reorder.h)
+ *      - Give each worker its own block of discovery times instead of one shared clock
  *
- * Q11: What's the significance of #pragma omp parallel for?
- * A11: Distributes loop iterations across threads, useful for processing adjacent vertices.
+ * Q11: Is the result the same as a sequential DFS?
+ * A11: With one thread, yes. With several, every tree is still depth-first within a
+ *      worker and the [discovery, finish] intervals nest, but a non-tree edge may
+ *      join two subtrees explored by different workers.
  *
  * Q12: How does false sharing affect performance?
  * A12: Adjacent elements in visited array accessed by different threads can cause cache line bouncing.
@@ -214,7 +249,7 @@ int main()
  * A14: Parallel version can be faster for large graphs but has overhead for small graphs.
  *
  * Q15: What are the limitations of this implementation?
- * A15: - No handling of disconnected components
+ * A15: - Disconnected components only with parallelDFS(g, start, true)
  *      - Potential overhead for small graphs
  *      - Memory contention in dense graphs
  *
@@ -9,109 +9,169 @@
  *    (if above not worked): g++ 04_Merge_Sort.cpp -o 04_Merge_Sort
  *    (General command): g++ -fopenmp fileName.cpp -o fileName or g++ fileName.cpp -o fileName
  * 3. Run: ./04_Merge_Sort or .\04_Merge_Sort
+ *    Larger inputs: ./04_Merge_Sort [n] [--algo all|merge|radix|sample] [--cutoff 16384]
+ *                   [--isa avx512|avx2|scalar] [--range 100000]
+ *    e.g. ./04_Merge_Sort 100000000 --algo sample (compile with -O2; mergesort.h, sortnet.h,
+ *    radixsort.h and samplesort.h must be next to the file). --isa lowers the SIMD sort
+ *    kernels from the best the CPU supports; a small --range gives many duplicate keys.
  */
 
 #include <iostream>
 #include <vector>
+#include <string>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
+#include <algorithm>
 #include <omp.h>
+#include "mergesort.h"
+#include "radixsort.h"
+#include "samplesort.h"
 using namespace std;
 
-// Merge function
-void merge(vector<int> &arr, int l, int m, int r)
+// The sort engines live in headers: mergesort.h (task-parallel merge sort with merge-path
+// merges), sortnet.h (its SIMD kernels), radixsort.h and samplesort.h
+
+struct SortOptions
 {
-    vector<int> temp;
-    int left = l, right = m + 1;
+    int n = 100000; // Adjust size to see clear performance difference
+    string algo = "all";
+    int64_t cutoff = DEFAULT_TASK_CUTOFF;
+    string isa;
+    int range = 100000; // keys are rand() % range
+};
 
-    while (left <= m && right <= r)
+bool parseArgs(int argc, char *argv[], SortOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
     {
-        if (arr[left] <= arr[right])
-            temp.push_back(arr[left++]);
+        string key = argv[i];
+        if (i == 1 && key.compare(0, 2, "--") != 0)
+        {
+            opt.n = atoi(argv[i]);
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        string value = argv[++i];
+        if (key == "--algo" && (value == "all" || value == "merge" || value == "radix" || value == "sample"))
+            opt.algo = value;
+        else if (key == "--cutoff")
+            opt.cutoff = atoll(value.c_str());
+        else if (key == "--isa" && (value == "avx512" || value == "avx2" || value == "scalar"))
+            opt.isa = value;
+        else if (key == "--range")
+            opt.range = atoi(value.c_str());
         else
-            temp.push_back(arr[right++]);
+            return false;
     }
-
-    while (left <= m)
-        temp.push_back(arr[left++]);
-
-    while (right <= r)
-        temp.push_back(arr[right++]);
-
-    for (int i = l; i <= r; ++i)
-        arr[i] = temp[i - l];
+    return opt.n >= 10 && opt.cutoff >= 1 && opt.range >= 1;
 }
 
-// Sequential Merge Sort
-void sequentialMergeSort(vector<int> &arr, int l, int r)
+double secondsSince(chrono::high_resolution_clock::time_point start)
 {
-    if (l < r)
-    {
-        int m = l + (r - l) / 2;
-        sequentialMergeSort(arr, l, m);
-        sequentialMergeSort(arr, m + 1, r);
-        merge(arr, l, m, r);
-    }
+    return chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
 }
 
-// Parallel Merge Sort
-void parallelMergeSort(vector<int> &arr, int l, int r)
+int main(int argc, char *argv[])
 {
-    if (l < r)
+    SortOptions opt;
+    if (!parseArgs(argc, argv, opt))
     {
-        int m = l + (r - l) / 2;
-
-#pragma omp parallel sections
-        {
-#pragma omp section
-            parallelMergeSort(arr, l, m);
-
-#pragma omp section
-            parallelMergeSort(arr, m + 1, r);
-        }
-
-        merge(arr, l, m, r);
+        cout << "Usage: " << argv[0] << " [n >= 10] [--algo all|merge|radix|sample] [--cutoff 16384]"
+             << " [--isa avx512|avx2|scalar] [--range 100000]" << endl;
+        return 1;
     }
-}
+    SimdLevel level = opt.isa == "scalar" ? SIMD_SCALAR : opt.isa == "avx2" ? SIMD_AVX2 : sortNetLevel();
+    if (level > sortNetLevel() || (opt.isa == "avx512" && sortNetLevel() != SIMD_AVX512))
+    {
+        cout << "This CPU only supports the " << simdLevelName(sortNetLevel()) << " sort kernels" << endl;
+        return 1;
+    }
+    sortNetLevel() = level;
 
-int main()
-{
-    int n = 100000; // Adjust size to see clear performance difference
-    cout << "Generating " << n << " random numbers..." << endl;
+    int n = opt.n;
+    cout << "Generating " << n << " random numbers below " << opt.range << " (" << simdLevelName(level)
+         << " sort kernels, " << omp_get_max_threads() << " threads)..." << endl;
 
-    vector<int> arr(n), arr_copy(n);
+    vector<int> input(n), arr(n), arr_copy(n), scratch(n);
     srand(time(0));
 
     for (int i = 0; i < n; ++i)
-        arr[i] = rand() % 100000;
+        input[i] = rand() % opt.range;
 
-    arr_copy = arr; // Copy for parallel version
-
-    auto seqStart = chrono::high_resolution_clock::now();
-    sequentialMergeSort(arr, 0, n - 1);
-    auto seqEnd = chrono::high_resolution_clock::now();
-
-    auto parStart = chrono::high_resolution_clock::now();
-    parallelMergeSort(arr_copy, 0, n - 1);
-    auto parEnd = chrono::high_resolution_clock::now();
+    // The sequential merge sort is the baseline every other algorithm is checked and timed against
+    arr = input;
+    auto start = chrono::high_resolution_clock::now();
+    sequentialMergeSort(arr.data(), n, scratch.data());
+    double seqTime = secondsSince(start);
+    bool ok = is_sorted(arr.begin(), arr.end());
 
     cout << "\nFirst 10 elements of sorted array (sequential): ";
     for (int i = 0; i < 10; ++i)
         cout << arr[i] << " ";
+    cout << "\n\nSequential Merge Sort time: " << seqTime << " seconds\n";
 
-    cout << "\nFirst 10 elements of sorted array (parallel): ";
-    for (int i = 0; i < 10; ++i)
-        cout << arr_copy[i] << " ";
+    // Runs one algorithm on a fresh copy of the input and compares it with the baseline
+    auto run = [&](const string &name, auto sortCopy)
+    {
+        arr_copy = input;
+        auto t0 = chrono::high_resolution_clock::now();
+        string detail = sortCopy();
+        double seconds = secondsSince(t0);
+        bool same = arr_copy == arr;
+        ok = ok && same;
+        cout << name << " time: " << seconds << " seconds, speedup " << seqTime / seconds << "x"
+             << (detail.empty() ? "" : " (" + detail + ")") << (same ? "" : " WRONG RESULT") << "\n";
+    };
 
-    chrono::duration<double> seqDuration = seqEnd - seqStart;
-    chrono::duration<double> parDuration = parEnd - parStart;
+    if (opt.algo == "all" || opt.algo == "merge")
+    {
+        run("Parallel Merge Sort", [&]()
+            {
+                parallelMergeSort(arr_copy.data(), n, scratch.data(), opt.cutoff);
+                return "task cutoff " + to_string(opt.cutoff);
+            });
+
+        // Standalone merge of two sorted runs: the even and the odd positions of the result
+        vector<int> evens, odds;
+        for (int i = 0; i < n; ++i)
+            (i % 2 == 0 ? evens : odds).push_back(arr[i]);
 
-    cout << "\n\nSequential Merge Sort time: " << seqDuration.count() << " seconds";
-    cout << "\nParallel Merge Sort time:   " << parDuration.count() << " seconds";
-    cout << "\nSpeedup: " << seqDuration.count() / parDuration.count() << "x\n";
+        start = chrono::high_resolution_clock::now();
+        mergeRuns(evens.data(), evens.data() + evens.size(), odds.data(), odds.data() + odds.size(), scratch.data());
+        double seqMerge = secondsSince(start);
+        start = chrono::high_resolution_clock::now();
+        parallelMerge(evens.data(), (int64_t)evens.size(), odds.data(), (int64_t)odds.size(), arr_copy.data());
+        double parMerge = secondsSince(start);
+
+        bool merged = scratch == arr && arr_copy == arr;
+        ok = ok && merged;
+        cout << "  Merge of two sorted runs: sequential " << seqMerge << " s, merge path " << parMerge
+             << " s, speedup " << seqMerge / parMerge << "x" << (merged ? "" : " (WRONG RESULT)") << "\n";
+    }
 
-    return 0;
+    if (opt.algo == "all" || opt.algo == "radix")
+        run("Parallel Radix Sort", [&]()
+            {
+                int passes = parallelRadixSort(arr_copy.data(), n, scratch.data());
+                if (n < RADIX_MIN_SIZE)
+                    return "std::sort below " + to_string(RADIX_MIN_SIZE) + " elements";
+                return to_string(passes) + " of 4 byte passes, the others had a constant digit";
+            });
+
+    if (opt.algo == "all" || opt.algo == "sample")
+        run("Parallel Sample Sort", [&]()
+            {
+                SampleSortStats st = parallelSampleSort(arr_copy.data(), n, scratch.data());
+                if (n < SAMPLE_SORT_MIN)
+                    return "merge sort below " + to_string(SAMPLE_SORT_MIN) + " elements";
+                return to_string(st.buckets) + " buckets, " + to_string(st.splitters) + " splitters, largest bucket " +
+                       to_string(st.largestBucket) + ", " + to_string(st.equalKeys) + " keys in equality buckets";
+            });
+
+    cout << "All results sorted and equal: " << (ok ? "yes" : "NO") << endl;
+    return ok ? 0 : 1;
 }
 
 /*
@@ -129,7 +189,7 @@ int main()
  * 1. OpenMP (#pragma omp)
  *    - A parallel programming API for shared-memory multiprocessing
  *    - Used for parallelizing computationally intensive tasks
- *    - Examples: parallel for loops, sections, tasks
+ *    - Examples: parallel for loops, sections, tasks (tasks are used here)
  *    - Other applications: matrix multiplication, image processing
  *
  * 2. Chrono Library
@@ -141,17 +201,20 @@ int main()
  * ---------------
  * 1. Vector<int>
  *    - Dynamic array implementation
- *    - Used for main array and temporary storage
- *    - Allows dynamic resizing during merge operations
+ *    - Used for the main array and one scratch array of the same size
+ *    - Both are allocated once; merges alternate between them (ping-pong)
  *
  * Complexity Analysis:
  * ------------------
  * Time Complexity:
  * - Sequential: O(n log n) - standard merge sort
  * - Parallel: O(n log n / p) where p is number of processors
+ * - Radix sort (radixsort.h): O(n * passes / p), one pass per non-constant byte of the keys
+ * - Sample sort (samplesort.h): O(n log n / p), but only two passes over memory before the
+ *   buckets are sorted in cache
  *
  * Space Complexity:
- * - O(n) for temporary arrays during merging
+ * - O(n) for the single scratch array
  *
  * Parallel Performance Factors:
  * ---------------------------
@@ -163,17 +226,18 @@ int main()
  * Q&A Section:
  * -----------
  * Q1: What is OpenMP and how is it used here?
- * A1: OpenMP is a parallel programming API. Here it's used via #pragma omp parallel sections
- *     to split merge sort recursion into parallel tasks.
+ * A1: OpenMP is a parallel programming API. Here one #pragma omp parallel region is opened and
+ *     the recursion spawns #pragma omp task for the left half down to a size cutoff.
  *
  * Q2: Why use vector instead of array?
- * A2: Vectors provide dynamic sizing needed for merge operations and are exception-safe.
+ * A2: Vectors free their memory automatically; large stack arrays would overflow the stack.
  *
  * Q3: What's the minimum array size for parallel efficiency?
  * A3: Generally, arrays should be >10000 elements for parallel overhead to be worthwhile.
  *
  * Q4: How does the merge function work?
- * A4: It combines two sorted subarrays by comparing elements and creating a temporary sorted array.
+ * A4: mergeRuns() combines two sorted runs of one buffer into the other buffer; the next level
+ *     up merges back the other way, so nothing is copied back.
  *
  * Q5: Why use chrono instead of time.h?
  * A5: Chrono provides higher precision and type-safe duration calculations.
@@ -185,7 +249,8 @@ int main()
  * A7: Theoretically linear with cores, but practically sub-linear due to overhead and memory bottlenecks.
  *
  * Q8: What's the significance of sections vs parallel for?
- * A8: Sections create independent task blocks, while parallel for distributes loop iterations.
+ * A8: Sections create independent blocks but opening one region per recursion level is costly;
+ *     tasks reuse the threads of one region, while parallel for distributes loop iterations.
  *
  * Q9: How is thread safety ensured?
  * A9: Each thread works on separate array sections, preventing data races.
@@ -200,7 +265,9 @@ int main()
  * A12: Prevents integer overflow for large arrays and maintains proper indexing.
  *
  * Q13: What's the base case for recursion?
- * A13: When l >= r, meaning the subarray has 1 or 0 elements.
+ * A13: Blocks of up to 256 ints are sorted by SIMD sorting networks (sortnet.h; insertion sort
+ *      of up to 32 elements without AVX2); ranges below the task cutoff are sorted sequentially
+ *      without creating tasks.
  *
  * Q14: How does load balancing work?
  * A14: OpenMP runtime distributes tasks across threads, but subarray sizes may vary.
@@ -209,11 +276,18 @@ int main()
  * A15: Better cache usage improves performance; sequential access patterns are preferred.
  *
  * Q16: Can this be further parallelized?
- * A16: Yes, the merge operation itself could be parallelized for additional speedup.
+ * A16: The merge itself is parallel too: merge path (coRank in mergesort.h) cuts a large merge
+ *      into equal independent pieces, so even the top-level merge uses all threads.
+ *
+ * Q17: How does the radix sort compare?
+ * A17: It never compares keys: each pass over 8-bit digits moves every key once with O(n) work,
+ *      and keys below 100000 need only 3 of the 4 passes (the top byte is always 0). The SIMD
+ *      merge sort compares 8 or 16 keys per instruction but makes log n passes, so which one
+ *      wins depends on n, the number of threads and the vector width.
  *
- * Q17: Why use srand(time(0))?
- * A17: Ensures different random numbers on each run for realistic testing.
+ * Q18: Why use srand(time(0))?
+ * A18: Ensures different random numbers on each run for realistic testing.
  *
- * Q18: What's the memory overhead?
- * A18: O(n) extra space for temporary arrays during merging, plus thread stack space.
+ * Q19: What's the memory overhead?
+ * A19: O(n) extra space for the one scratch array, plus thread stack space.
  */
\ No newline at end of file
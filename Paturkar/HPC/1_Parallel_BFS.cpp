@@ -1,105 +1,158 @@
-#include <iostream>
-#include <vector>
-#include <queue>
-#include <omp.h>
-
-using namespace std;
-
-class TreeGraph {
-    int numNodes;
-    vector<vector<int>> adjacencyList;
-
-public:
-    TreeGraph(int nodes) {
-        numNodes = nodes;
-        adjacencyList.resize(nodes);
-    }
-
-    void connect(int from, int to) {
-        adjacencyList[from].push_back(to);
-        adjacencyList[to].push_back(from); // Undirected edge
-    }
-
-    void parallelBFS(int startNode) {
-        vector<bool> isVisited(numNodes, false);
-        queue<int> nodeQueue;
-
-        isVisited[startNode] = true;
-        nodeQueue.push(startNode);
-
-        while (!nodeQueue.empty()) {
-            int current = nodeQueue.front();
-            nodeQueue.pop();
-
-            cout << current << " ";
-
-            // Traverse neighbors in parallel
-            #pragma omp parallel for
-            for (int i = 0; i < adjacencyList[current].size(); ++i) {
-                int neighbor = adjacencyList[current][i];
-
-                if (!isVisited[neighbor]) {
-                    #pragma omp critical
-                    {
-                        if (!isVisited[neighbor]) {
-                            isVisited[neighbor] = true;
-                            nodeQueue.push(neighbor);
-                        }
-                    }
-                }
-            }
-        }
-        cout << endl;
-    }
-};
-
-int main() {
-    // Demo 1
-    cout << "Tree Example 1:\n";
-    TreeGraph t1(6);
-    t1.connect(0, 1);
-    t1.connect(0, 2);
-    t1.connect(1, 3);
-    t1.connect(1, 4);
-    t1.connect(2, 5);
-    cout << "BFS from node 0: ";
-    t1.parallelBFS(0);
-
-    cout << "\n";
-
-    // Demo 2
-    cout << "Tree Example 2:\n";
-    TreeGraph t2(7);
-    t2.connect(0, 1);
-    t2.connect(0, 2);
-    t2.connect(1, 3);
-    t2.connect(2, 4);
-    t2.connect(3, 5);
-    t2.connect(4, 6);
-    cout << "BFS from node 0: ";
-    t2.parallelBFS(0);
-
-    cout << "\n";
-
-    // Custom input
-    int vertices, edges;
-    cout << "Enter total vertices: ";
-    cin >> vertices;
-
-    TreeGraph userTree(vertices);
-
-    cout << "Enter number of edges: ";
-    cin >> edges;
-
-    cout << "Enter each edge (u v):" << endl;
-    for (int i = 0; i < edges; ++i) {
-        int u, v;
-        cin >> u >> v;
-        userTree.connect(u, v);
-    }
-
-    cout << "Parallel BFS result:\n";
-    userTree.parallelBFS(0);
-
-    return 0;
-}
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <omp.h>
+
+using namespace std;
+
+class TreeGraph {
+    int numNodes;
+    vector<vector<int>> adjacencyList;
+
+public:
+    TreeGraph(int nodes) {
+        numNodes = nodes;
+        adjacencyList.resize(nodes);
+    }
+
+    void connect(int from, int to) {
+        adjacencyList[from].push_back(to);
+        adjacencyList[to].push_back(from); // Undirected edge
+    }
+
+    // Level-synchronous BFS: each level is expanded by all threads at once,
+    // nodes are claimed with an atomic compare-and-swap on a bitmap, and the
+    // per-thread discoveries are joined with a prefix sum (no critical, no queue).
+    // Nothing is printed here: the visit order, level and parent of every node are
+    // written into the caller's buffers (reused across calls), see printOrder()
+    void parallelBFS(int startNode, vector<int> &order, vector<int> &level, vector<int> &parent) {
+        vector<unsigned long long> isVisited((numNodes + 63) / 64, 0);
+        order.resize(numNodes);
+        level.assign(numNodes, -1);
+        parent.assign(numNodes, -1);
+
+        isVisited[startNode / 64] |= 1ULL << (startNode % 64);
+        order[0] = startNode;
+        level[startNode] = 0;
+        size_t head = 0, tail = 1; // current level is order[head .. tail)
+
+        int numThreads = omp_get_max_threads();
+        vector<vector<int>> found(numThreads);
+        vector<size_t> writeAt(numThreads + 1, 0);
+
+        for (int depth = 1; head < tail; ++depth) {
+            // The team may be smaller than numThreads (OMP_DYNAMIC, thread limits), so
+            // every buffer is cleared up front and the scan covers only the team that ran
+            for (vector<int> &f : found)
+                f.clear();
+            int used = numThreads;
+
+            #pragma omp parallel num_threads(numThreads)
+            {
+                int tid = omp_get_thread_num();
+
+                #pragma omp for schedule(dynamic, 64)
+                for (size_t i = head; i < tail; ++i) {
+                    int current = order[i];
+                    for (int neighbor : adjacencyList[current]) {
+                        unsigned long long *word = &isVisited[neighbor / 64];
+                        unsigned long long mask = 1ULL << (neighbor % 64);
+                        unsigned long long old = __atomic_load_n(word, __ATOMIC_RELAXED);
+                        while (!(old & mask)) {
+                            if (__atomic_compare_exchange_n(word, &old, old | mask, true,
+                                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                                level[neighbor] = depth;
+                                parent[neighbor] = current;
+                                found[tid].push_back(neighbor);
+                                break;
+                            }
+                        }
+                    }
+                }
+
+                #pragma omp single
+                {
+                    used = omp_get_num_threads();
+                    writeAt[0] = tail;
+                    for (int t = 0; t < used; ++t)
+                        writeAt[t + 1] = writeAt[t] + found[t].size();
+                }
+
+                copy(found[tid].begin(), found[tid].end(), order.begin() + writeAt[tid]);
+            }
+
+            head = tail;
+            tail = writeAt[used];
+        }
+        order.resize(tail);
+    }
+};
+
+// Separate output step: formats the whole order into one string and writes it once
+void printOrder(const vector<int> &order) {
+    string out;
+    out.reserve(order.size() * 8);
+    for (int node : order) {
+        out += to_string(node);
+        out += ' ';
+    }
+    out += '\n';
+    cout << out;
+}
+
+int main() {
+    vector<int> order, level, parent; // result buffers reused by every traversal
+
+    // Demo 1
+    cout << "Tree Example 1:\n";
+    TreeGraph t1(6);
+    t1.connect(0, 1);
+    t1.connect(0, 2);
+    t1.connect(1, 3);
+    t1.connect(1, 4);
+    t1.connect(2, 5);
+    cout << "BFS from node 0: ";
+    t1.parallelBFS(0, order, level, parent);
+    printOrder(order);
+
+    cout << "\n";
+
+    // Demo 2
+    cout << "Tree Example 2:\n";
+    TreeGraph t2(7);
+    t2.connect(0, 1);
+    t2.connect(0, 2);
+    t2.connect(1, 3);
+    t2.connect(2, 4);
+    t2.connect(3, 5);
+    t2.connect(4, 6);
+    cout << "BFS from node 0: ";
+    t2.parallelBFS(0, order, level, parent);
+    printOrder(order);
+
+    cout << "\n";
+
+    // Custom input
+    int vertices, edges;
+    cout << "Enter total vertices: ";
+    cin >> vertices;
+
+    TreeGraph userTree(vertices);
+
+    cout << "Enter number of edges: ";
+    cin >> edges;
+
+    cout << "Enter each edge (u v):" << endl;
+    for (int i = 0; i < edges; ++i) {
+        int u, v;
+        cin >> u >> v;
+        userTree.connect(u, v);
+    }
+
+    cout << "Parallel BFS result:\n";
+    userTree.parallelBFS(0, order, level, parent);
+    printOrder(order);
+
+    return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * Parallel BFS engines over the CSR Graph from graph.h.
+ *
+ * levelSyncBFS(g, start) / levelSyncBFS(g, start, result)
+ *   Level-synchronous BFS: the whole current frontier is expanded in parallel inside
+ *   a single OpenMP region (no fork per vertex), vertices are claimed with an atomic
+ *   bitmap, and every thread collects its discoveries in a private buffer. The buffers
+ *   are concatenated with a prefix sum over their sizes, so no critical section or
+ *   shared queue is needed.
+ *
+ * directionOptimizingBFS(g, start, alpha, beta)
+ *   The same engine, but levels whose frontier touches many edges are expanded
+ *   bottom-up: every unvisited vertex scans its neighbors for a parent in the frontier
+ *   and stops at the first hit. Since the Graph stores both directions of every edge,
+ *   the same CSR arrays serve both directions. result.direction records the choice
+ *   made for every level so alpha/beta can be tuned.
+ *
+ * multiSourceBFS(g, sources)
+ *   Bit-parallel multi-source BFS (MS-BFS): up to 256 searches share one adjacency sweep
+ *   per level. Returns per-source distance arrays and/or per-vertex distance sums.
+ *
+ * The frontier of each level is a slice of result.order: order[levelStart[d] ..
+ * levelStart[d + 1]) holds the vertices at distance d, which makes order a valid
+ * BFS visit order as well as the work queue.
+ */
+
+#ifndef BFS_H
+#define BFS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+
+// Traversals only fill these arrays and never print; see writer.h for output
+struct BFSResult
+{
+    std::vector<int> level;       // distance from start, -1 if unreached
+    std::vector<int> parent;      // BFS tree parent, -1 for start and unreached vertices
+    std::vector<int> order;       // reached vertices in visit order
+    std::vector<int> levelStart;  // order[levelStart[d] .. levelStart[d + 1]) is level d
+    std::vector<char> direction;  // per expanded level: 'T' top-down or 'B' bottom-up
+    std::vector<int64_t> frontierEdges; // per expanded level: sum of frontier degrees
+    std::vector<double> levelSeconds;   // per expanded level: wall time in seconds
+};
+
+struct BFSOptions
+{
+    bool directionOptimizing = false;
+    double alpha = 15; // top-down -> bottom-up when frontier edges > unexplored edges / alpha
+    double beta = 18;  // bottom-up -> top-down when frontier size < V / beta
+};
+
+// Atomic bitmap with one bit per vertex; claim() succeeds for exactly one caller
+struct AtomicBitmap
+{
+    std::vector<uint64_t> words;
+
+    AtomicBitmap(int n = 0) : words((n + 63) / 64, 0) {}
+
+    bool test(int v) const
+    {
+        return (__atomic_load_n(&words[v >> 6], __ATOMIC_RELAXED) >> (v & 63)) & 1;
+    }
+
+    bool claim(int v)
+    {
+        uint64_t *word = &words[v >> 6];
+        uint64_t mask = 1ULL << (v & 63);
+        uint64_t old = __atomic_load_n(word, __ATOMIC_RELAXED);
+        while (!(old & mask))
+        {
+            if (__atomic_compare_exchange_n(word, &old, old | mask, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                return true;
+        }
+        return false; // someone else set the bit first
+    }
+};
+
+// Fills r, reusing its buffers across calls; the visited bitmap and the per-thread
+// frontier buffers are still allocated by every call.
+// G is Graph or any graph with the same V / degree() / numEdges() / begin() / end()
+// interface, e.g. CompressedGraph (compressed.h), whose begin()/end() are iterators.
+template <class G>
+void levelSyncBFS(const G &g, int start, BFSResult &r, const BFSOptions &opt = BFSOptions())
+{
+    r.level.assign(g.V, -1);
+    r.parent.assign(g.V, -1);
+    r.order.resize(g.V);
+    r.levelStart.clear();
+    r.direction.clear();
+    r.frontierEdges.clear();
+    r.levelSeconds.clear();
+
+    AtomicBitmap visited(g.V);
+    visited.claim(start);
+    r.level[start] = 0;
+    r.order[0] = start;
+    r.levelStart.push_back(0);
+
+    int64_t head = 0, tail = 1;              // current frontier is order[head .. tail)
+    int64_t frontierEdges = g.degree(start); // m_f: edges out of the frontier
+    int64_t unexploredEdges = g.numEdges() - frontierEdges; // m_u: edges out of unvisited vertices
+    bool bottomUp = false;
+    int depth = 0;
+    std::vector<int64_t> writeAt, edgesAt;
+    double levelClock = omp_get_wtime();
+
+#pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int nthreads = omp_get_num_threads();
+        std::vector<int> local;
+
+#pragma omp single
+        {
+            writeAt.assign(nthreads + 1, 0);
+            edgesAt.assign(nthreads, 0);
+        }
+
+        while (head < tail)
+        {
+            local.clear();
+
+            if (!bottomUp)
+            {
+                // Top-down: push from every frontier vertex to its unvisited neighbors
+#pragma omp for schedule(dynamic, 64)
+                for (int64_t i = head; i < tail; i++)
+                {
+                    int u = r.order[i];
+                    for (auto p = g.begin(u), last = g.end(u); p != last; ++p)
+                    {
+                        int v = *p;
+                        if (!visited.test(v) && visited.claim(v))
+                        {
+                            r.parent[v] = u;
+                            r.level[v] = depth + 1;
+                            local.push_back(v);
+                        }
+                    }
+                }
+            }
+            else
+            {
+                // Bottom-up: every unvisited vertex looks for any neighbor in the frontier
+                // and stops at the first one, skipping the rest of its edges
+#pragma omp for schedule(dynamic, 1024)
+                for (int v = 0; v < g.V; v++)
+                {
+                    if (visited.test(v))
+                        continue;
+                    for (auto p = g.begin(v), last = g.end(v); p != last; ++p)
+                    {
+                        if (__atomic_load_n(&r.level[*p], __ATOMIC_RELAXED) == depth)
+                        {
+                            r.parent[v] = *p;
+                            __atomic_store_n(&r.level[v], depth + 1, __ATOMIC_RELAXED);
+                            visited.claim(v);
+                            local.push_back(v);
+                            break;
+                        }
+                    }
+                }
+            }
+
+            // Prefix sum over per-thread buffer sizes gives each thread its output slot
+            int64_t localEdges = 0;
+            for (int v : local)
+                localEdges += g.degree(v);
+            edgesAt[tid] = localEdges;
+            writeAt[tid + 1] = local.size();
+#pragma omp barrier
+#pragma omp single
+            {
+                writeAt[0] = tail;
+                for (int t = 0; t < nthreads; t++)
+                    writeAt[t + 1] += writeAt[t];
+            }
+
+            std::copy(local.begin(), local.end(), r.order.begin() + writeAt[tid]);
+#pragma omp barrier
+
+#pragma omp single
+            {
+                r.direction.push_back(bottomUp ? 'B' : 'T');
+                r.frontierEdges.push_back(frontierEdges);
+                double now = omp_get_wtime();
+                r.levelSeconds.push_back(now - levelClock);
+                levelClock = now;
+
+                int64_t prevSize = tail - head;
+                head = tail;
+                tail = writeAt[nthreads];
+                depth++;
+                r.levelStart.push_back(head);
+
+                frontierEdges = 0;
+                for (int t = 0; t < nthreads; t++)
+                    frontierEdges += edgesAt[t];
+                unexploredEdges -= frontierEdges;
+
+                // Switch heuristics: go bottom-up once the growing frontier has more edges
+                // than m_u / alpha, return top-down once the shrinking frontier drops
+                // below V / beta vertices
+                int64_t size = tail - head;
+                if (opt.directionOptimizing)
+                {
+                    if (!bottomUp && size > prevSize && frontierEdges > unexploredEdges / opt.alpha)
+                        bottomUp = true;
+                    else if (bottomUp && size < prevSize && size < g.V / opt.beta)
+                        bottomUp = false;
+                }
+            }
+        }
+    }
+
+    r.order.resize(tail);
+}
+
+template <class G>
+BFSResult levelSyncBFS(const G &g, int start, const BFSOptions &opt = BFSOptions())
+{
+    BFSResult r;
+    levelSyncBFS(g, start, r, opt);
+    return r;
+}
+
+// Direction-optimizing BFS: same engine, switching between top-down and bottom-up
+template <class G>
+BFSResult directionOptimizingBFS(const G &g, int start, double alpha = 15, double beta = 18)
+{
+    BFSOptions opt;
+    opt.directionOptimizing = true;
+    opt.alpha = alpha;
+    opt.beta = beta;
+    return levelSyncBFS(g, start, opt);
+}
+
+struct MultiSourceBFSResult
+{
+    std::vector<int> sources;
+    std::vector<std::vector<int>> dist; // dist[i][v] from sources[i], -1 if unreached (only if kept)
+    std::vector<int64_t> distSum;       // per vertex: sum of distances from the sources reaching it
+    std::vector<int> reachedBy;         // per vertex: number of sources reaching it
+};
+
+// One batch of up to 64 * W sources. Every vertex keeps W words of "seen-by" bits and
+// pulls the "visit" bits of its neighbors, so a single adjacency sweep per level
+// advances all the searches of the batch. Only the owning thread writes a vertex's
+// bits, so no atomics are needed.
+template <int W>
+void multiSourceBFSBatch(const Graph &g, const int *sources, int count, int firstIndex,
+                         MultiSourceBFSResult &r, bool keepDistances)
+{
+    int64_t n = (int64_t)g.V * W;
+    std::vector<uint64_t> seen(n, 0), visit(n, 0), next(n, 0);
+
+    uint64_t full[W];
+    for (int w = 0; w < W; w++)
+    {
+        int bits = count - 64 * w;
+        full[w] = bits >= 64 ? ~0ULL : bits <= 0 ? 0 : (1ULL << bits) - 1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int s = sources[i];
+        seen[(int64_t)s * W + i / 64] |= 1ULL << (i % 64);
+        visit[(int64_t)s * W + i / 64] |= 1ULL << (i % 64);
+        r.reachedBy[s]++;
+        if (keepDistances)
+            r.dist[firstIndex + i][s] = 0;
+    }
+
+    bool active = count > 0;
+    for (int depth = 1; active; depth++)
+    {
+        active = false;
+
+#pragma omp parallel for schedule(dynamic, 1024) reduction(|| : active)
+        for (int v = 0; v < g.V; v++)
+        {
+            uint64_t *sv = &seen[(int64_t)v * W];
+            uint64_t *nv = &next[(int64_t)v * W];
+
+            bool done = true;
+            for (int w = 0; w < W; w++)
+                done = done && sv[w] == full[w];
+            if (done)
+            {
+                for (int w = 0; w < W; w++)
+                    nv[w] = 0;
+                continue; // every search of the batch has already reached v
+            }
+
+            uint64_t acc[W] = {};
+            for (const int *p = g.begin(v); p != g.end(v); ++p)
+            {
+                const uint64_t *in = &visit[(int64_t)*p * W];
+                for (int w = 0; w < W; w++)
+                    acc[w] |= in[w];
+            }
+
+            int found = 0;
+            for (int w = 0; w < W; w++)
+            {
+                acc[w] &= ~sv[w];
+                nv[w] = acc[w];
+                sv[w] |= acc[w];
+                found += __builtin_popcountll(acc[w]);
+
+                if (keepDistances)
+                    for (uint64_t bits = acc[w]; bits; bits &= bits - 1)
+                        r.dist[firstIndex + 64 * w + __builtin_ctzll(bits)][v] = depth;
+            }
+
+            if (found)
+            {
+                r.distSum[v] += (int64_t)found * depth;
+                r.reachedBy[v] += found;
+                active = true;
+            }
+        }
+
+        visit.swap(next);
+    }
+}
+
+// Runs BFS from every vertex in sources, 256 at a time (64 for small batches)
+inline MultiSourceBFSResult multiSourceBFS(const Graph &g, const std::vector<int> &sources, bool keepDistances = true)
+{
+    MultiSourceBFSResult r;
+    r.sources = sources;
+    r.distSum.assign(g.V, 0);
+    r.reachedBy.assign(g.V, 0);
+    if (keepDistances)
+        r.dist.assign(sources.size(), std::vector<int>(g.V, -1));
+
+    for (size_t first = 0; first < sources.size(); first += 256)
+    {
+        int count = (int)std::min<size_t>(256, sources.size() - first);
+        if (count <= 64)
+            multiSourceBFSBatch<1>(g, sources.data() + first, count, (int)first, r, keepDistances);
+        else
+            multiSourceBFSBatch<4>(g, sources.data() + first, count, (int)first, r, keepDistances);
+    }
+    return r;
+}
+
+#endif
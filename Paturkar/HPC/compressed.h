@@ -0,0 +1,223 @@
+/*
+ * Compressed adjacency lists for graphs that do not fit in memory as plain CSR.
+ *
+ * CompressedGraph
+ *   Every neighbor list is sorted and stored as a byte string:
+ *     varint  degree
+ *     varint  zigzag(first neighbor - u)    (signed: neighbors are often close to u)
+ *     varint  gap - 1 for every further neighbor (lists are strictly increasing)
+ *   Varints are byte-aligned LEB128: 7 bits per byte, high bit set on all but the last.
+ *   Small gaps, the common case after a locality ordering (reorder.h), take one byte
+ *   instead of four. The byte where u's list starts is blockBase[u / 64] + rel[u]:
+ *   one 64-bit base per 64 vertices plus a 32-bit offset per vertex, about half the
+ *   memory of a 64-bit offset per vertex. The lists of 64 consecutive vertices must
+ *   stay below 4 GB; fromGraph() checks every block and stops the program otherwise
+ *   instead of storing truncated offsets.
+ *
+ *   begin(u) / end(u) return a NeighborIterator that decodes one neighbor per ++, so
+ *   the traversal engines in bfs.h and dfs.h run on a CompressedGraph unchanged:
+ *     CompressedGraph cg = CompressedGraph::fromGraph(g);
+ *     BFSResult r = levelSyncBFS(cg, 0);
+ *
+ * Duplicate neighbors are dropped while encoding.
+ */
+
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+
+// Appends x as a varint; returns the new end
+inline uint8_t *encodeVarint(uint8_t *out, uint32_t x)
+{
+    while (x >= 0x80)
+    {
+        *out++ = (uint8_t)(x | 0x80);
+        x >>= 7;
+    }
+    *out++ = (uint8_t)x;
+    return out;
+}
+
+inline int varintSize(uint32_t x)
+{
+    int n = 1;
+    while (x >= 0x80)
+    {
+        x >>= 7;
+        n++;
+    }
+    return n;
+}
+
+// Decodes one varint at p and advances p; one-byte values take the fast path
+inline uint32_t decodeVarint(const uint8_t *&p)
+{
+    uint32_t x = *p++;
+    if (x < 0x80)
+        return x;
+    x &= 0x7F;
+    for (int shift = 7;; shift += 7)
+    {
+        uint32_t b = *p++;
+        x |= (b & 0x7F) << shift;
+        if (b < 0x80)
+            return x;
+    }
+}
+
+inline uint32_t zigzag(int32_t x) { return ((uint32_t)x << 1) ^ (uint32_t)(x >> 31); }
+inline int32_t unzigzag(uint32_t x) { return (int32_t)(x >> 1) ^ -(int32_t)(x & 1); }
+
+// Forward iterator over one compressed neighbor list. Holds the position of the
+// current neighbor's encoding, its decoded value and the position of the next one.
+class NeighborIterator
+{
+    const uint8_t *cur;
+    const uint8_t *nextPos;
+    int value;
+
+public:
+    NeighborIterator(const uint8_t *p = nullptr, const uint8_t *end = nullptr, int u = 0)
+        : cur(p), nextPos(p), value(u)
+    {
+        if (p != end)
+            value = u + unzigzag(decodeVarint(nextPos));
+    }
+
+    int operator*() const { return value; }
+
+    NeighborIterator &operator++()
+    {
+        cur = nextPos;
+        value += (int)decodeVarint(nextPos) + 1; // reads the padding past the last list
+        return *this;
+    }
+
+    bool operator!=(const NeighborIterator &o) const { return cur != o.cur; }
+    bool operator==(const NeighborIterator &o) const { return cur == o.cur; }
+};
+
+struct CompressedGraph
+{
+    int V = 0;
+    std::vector<int64_t> blockBase; // byte offset of every 64th vertex's list
+    std::vector<uint32_t> rel;      // byte offset of u's list from blockBase[u / 64], size V + 1
+    std::vector<uint8_t> bytes;     // encoded lists plus a few padding bytes
+    int64_t edges = 0;              // directed entries (2E)
+
+    int64_t offset(int u) const { return blockBase[u >> 6] + rel[u]; }
+
+    // Encodes g in two parallel passes: sizes (then a prefix sum), then the bytes
+    static CompressedGraph fromGraph(const Graph &g)
+    {
+        CompressedGraph c;
+        c.V = g.V;
+        std::vector<int64_t> offsets(g.V + 1, 0);
+        int64_t edges = 0;
+
+#pragma omp parallel reduction(+ : edges)
+        {
+            std::vector<int> list;
+
+#pragma omp for schedule(dynamic, 1024)
+            for (int u = 0; u < g.V; u++)
+            {
+                sortedNeighbors(g, u, list);
+                int64_t size = varintSize((uint32_t)list.size());
+                for (size_t i = 0; i < list.size(); i++)
+                    size += varintSize(i == 0 ? zigzag(list[0] - u) : (uint32_t)(list[i] - list[i - 1] - 1));
+                offsets[u + 1] = size;
+                edges += list.size();
+            }
+        }
+        c.edges = edges;
+
+        parallelPrefixSum(offsets.data() + 1, g.V);
+        // rel[] is 32 bits: a block whose lists reach 4 GB cannot be addressed
+        int64_t span = 0;
+#pragma omp parallel for reduction(max : span)
+        for (int u = 0; u <= g.V; u++)
+            span = std::max(span, offsets[u] - offsets[u - u % 64]);
+        if (span > (int64_t)UINT32_MAX)
+        {
+            fprintf(stderr, "CompressedGraph: the lists of one 64-vertex block take %lld bytes, "
+                            "more than the 32-bit offsets can address\n", (long long)span);
+            exit(1);
+        }
+
+        c.bytes.assign(offsets[g.V] + 8, 0); // padding: ++ past a list may read ahead
+        c.blockBase.resize(g.V / 64 + 1);
+        c.rel.resize(g.V + 1);
+
+#pragma omp parallel for
+        for (int u = 0; u <= g.V; u++)
+        {
+            if (u % 64 == 0)
+                c.blockBase[u / 64] = offsets[u];
+            c.rel[u] = (uint32_t)(offsets[u] - offsets[u - u % 64]);
+        }
+
+#pragma omp parallel
+        {
+            std::vector<int> list;
+
+#pragma omp for schedule(dynamic, 1024)
+            for (int u = 0; u < g.V; u++)
+            {
+                sortedNeighbors(g, u, list);
+                uint8_t *out = c.bytes.data() + offsets[u];
+                out = encodeVarint(out, (uint32_t)list.size());
+                for (size_t i = 0; i < list.size(); i++)
+                    out = encodeVarint(out, i == 0 ? zigzag(list[0] - u) : (uint32_t)(list[i] - list[i - 1] - 1));
+            }
+        }
+        return c;
+    }
+
+    static CompressedGraph fromEdges(int V, const std::vector<std::pair<int, int>> &edges)
+    {
+        return fromGraph(Graph::fromEdges(V, edges));
+    }
+
+    static void sortedNeighbors(const Graph &g, int u, std::vector<int> &list)
+    {
+        list.assign(g.begin(u), g.end(u));
+        std::sort(list.begin(), list.end());
+        list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+
+    int degree(int u) const
+    {
+        const uint8_t *p = bytes.data() + offset(u);
+        return (int)decodeVarint(p);
+    }
+
+    int64_t numEdges() const { return edges; }
+
+    NeighborIterator begin(int u) const
+    {
+        const uint8_t *p = bytes.data() + offset(u);
+        decodeVarint(p); // skip the degree
+        return NeighborIterator(p, bytes.data() + offset(u + 1), u);
+    }
+
+    NeighborIterator end(int u) const
+    {
+        const uint8_t *p = bytes.data() + offset(u + 1);
+        return NeighborIterator(p, p, u);
+    }
+
+    size_t memoryBytes() const
+    {
+        return blockBase.size() * sizeof(int64_t) + rel.size() * sizeof(uint32_t) + bytes.size();
+    }
+};
+
+#endif
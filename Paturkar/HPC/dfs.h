@@ -0,0 +1,380 @@
+/*
+ * Parallel DFS engine over the CSR Graph from graph.h.
+ *
+ * parallelDFS(g, start, wholeGraph) / parallelDFS(g, start, result, wholeGraph)
+ *   Work-stealing DFS. Every OpenMP thread owns an explicit stack of (vertex, next edge)
+ *   frames and runs an ordinary depth-first scan on it, so there is no recursion,
+ *   no nested parallel region and never more threads than omp_get_max_threads().
+ *   A thread that runs out of work steals the bottom half of a random busy thread's
+ *   stack (the frames closest to the root, which have the most work left under them).
+ *   Vertices are claimed with the atomic bitmap from bfs.h, so each vertex is
+ *   discovered exactly once.
+ *
+ *   Discovery and finish times come from one shared clock. A vertex finishes once its
+ *   own edge scan and all of its children have finished, even when those children were
+ *   stolen by other threads, so every tree interval [discovery, finish] is properly
+ *   nested inside its parent's. With one thread the result is exactly the sequential
+ *   DFS; with several, a non-tree edge may also join subtrees explored by different
+ *   threads.
+ *
+ *   With wholeGraph set, a new tree is seeded from the next unvisited vertex whenever
+ *   all threads are idle, until the forest spans the whole graph (one tree per
+ *   connected component).
+ *
+ * sequentialDFS(g, start, result, visitor, wholeGraph)
+ *   The exact sequential DFS, for graphs too deep to recurse on (a 10M-vertex path needs
+ *   10M stack frames): one explicit stack of (vertex, next edge) frames, so the extra
+ *   memory is O(V) and the depth is only limited by the heap. Fills the same DFSResult,
+ *   and reports every event to a visitor (see DFSVisitor):
+ *     discover(v), finish(v)   in preorder and postorder
+ *     edge(u, v, type)         every scanned entry u -> v, classified with the
+ *                              discovery/finish times: tree, back (v still open),
+ *                              forward (v finished, discovered after u) or cross
+ *   Any hook can return false to stop the search at once; vertices still on the stack
+ *   then keep finish = -1. On an undirected Graph both directions of every edge are
+ *   scanned, so the way back up a tree edge is reported as a back edge to the parent.
+ */
+
+#ifndef DFS_H
+#define DFS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+#include "bfs.h"
+
+// Traversals only fill these arrays and never print; see writer.h for output
+struct DFSResult
+{
+    std::vector<int> parent;        // DFS forest parent, -1 for roots and unreached vertices
+    std::vector<int> depth;         // depth in the DFS forest, -1 if unreached
+    std::vector<int64_t> discovery; // discovery time, -1 if unreached
+    std::vector<int64_t> finish;    // finish time, -1 if unreached
+    std::vector<int> order;         // reached vertices by discovery time (preorder)
+    std::vector<int> postorder;     // finished vertices by finish time
+};
+
+enum DFSEdgeType
+{
+    TreeEdge,
+    BackEdge,
+    ForwardEdge,
+    CrossEdge
+};
+
+// Visitor for sequentialDFS with no-op hooks: derive from it and hide the ones needed.
+// Every hook returns false to stop the search.
+struct DFSVisitor
+{
+    bool discover(int) { return true; }
+    bool finish(int) { return true; }
+    bool edge(int, int, DFSEdgeType) { return true; }
+};
+
+// It is the graph's neighbor iterator: const int * for Graph, NeighborIterator for
+// CompressedGraph (compressed.h)
+template <class It>
+struct DFSFrame
+{
+    int v;
+    It next; // next neighbor of v to scan
+};
+
+template <class It>
+struct DFSWorker
+{
+    std::vector<DFSFrame<It>> stack;
+    omp_lock_t lock;
+    char pad[64]; // keep the locks of neighboring workers on separate cache lines
+};
+
+// Fills r, reusing its buffers across calls; the pending counts, the worker stacks and
+// the visit-order scratch are still allocated by every call. G is Graph or any graph
+// with the same interface (see levelSyncBFS)
+template <class G>
+void parallelDFS(const G &g, int start, DFSResult &r, bool wholeGraph = false)
+{
+    typedef decltype(g.begin(0)) It;
+
+    r.parent.assign(g.V, -1);
+    r.depth.assign(g.V, -1);
+    r.discovery.assign(g.V, -1);
+    r.finish.assign(g.V, -1);
+
+    AtomicBitmap visited(g.V);
+    std::vector<int> pending(g.V, 0); // own scan + unfinished children
+    int64_t clock = 0;
+    int64_t reached = 0;
+
+    int nthreads = omp_get_max_threads();
+    std::vector<DFSWorker<It>> workers(nthreads);
+    for (DFSWorker<It> &w : workers)
+        omp_init_lock(&w.lock);
+
+    int team = 1, idle = 0;
+    int seedCursor = 0;
+
+    auto discover = [&](int v, int p)
+    {
+        r.parent[v] = p;
+        r.depth[v] = p < 0 ? 0 : r.depth[p] + 1;
+        pending[v] = 1;
+        r.discovery[v] = __atomic_fetch_add(&clock, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&reached, 1, __ATOMIC_RELAXED);
+    };
+
+    // Drops one reference on v; the last one finishes v and releases its parent
+    auto release = [&](int v)
+    {
+        while (v >= 0 && __atomic_sub_fetch(&pending[v], 1, __ATOMIC_ACQ_REL) == 0)
+        {
+            r.finish[v] = __atomic_fetch_add(&clock, 1, __ATOMIC_RELAXED);
+            v = r.parent[v];
+        }
+    };
+
+    visited.claim(start);
+    discover(start, -1);
+    workers[0].stack.push_back({start, g.begin(start)});
+
+#pragma omp parallel num_threads(nthreads)
+    {
+#pragma omp single
+        {
+            team = omp_get_num_threads(); // may be fewer than asked for
+            idle = team - 1;
+        }
+
+        int tid = omp_get_thread_num();
+        DFSWorker<It> &me = workers[tid];
+        unsigned rng = 2654435761u * (tid + 1);
+        bool active = tid == 0;
+        std::vector<DFSFrame<It>> loot;
+
+        while (true)
+        {
+            if (active)
+            {
+                omp_set_lock(&me.lock);
+                if (me.stack.empty())
+                {
+                    omp_unset_lock(&me.lock);
+                    active = false;
+                    __atomic_add_fetch(&idle, 1, __ATOMIC_ACQ_REL);
+                    continue;
+                }
+                DFSFrame<It> f = me.stack.back(); // thieves never take the top frame
+                omp_unset_lock(&me.lock);
+
+                It e = f.next, end = g.end(f.v);
+                int child = -1;
+                for (; e != end; ++e)
+                {
+                    int w = *e;
+                    if (!visited.test(w) && visited.claim(w))
+                    {
+                        child = w;
+                        ++e;
+                        break;
+                    }
+                }
+
+                if (child >= 0)
+                {
+                    __atomic_add_fetch(&pending[f.v], 1, __ATOMIC_RELAXED);
+                    discover(child, f.v);
+                }
+
+                omp_set_lock(&me.lock);
+                me.stack.back().next = e;
+                if (child >= 0)
+                    me.stack.push_back({child, g.begin(child)});
+                else
+                    me.stack.pop_back();
+                omp_unset_lock(&me.lock);
+
+                if (child < 0)
+                    release(f.v);
+                continue;
+            }
+
+            bool seedsLeft = wholeGraph && __atomic_load_n(&seedCursor, __ATOMIC_RELAXED) < g.V;
+            if (!seedsLeft && __atomic_load_n(&idle, __ATOMIC_ACQUIRE) == team)
+                break; // every stack is empty and nobody is seeding
+
+            // Steal the bottom half of a random victim's stack
+            if (team > 1)
+            {
+                rng = rng * 1103515245u + 12345u;
+                int victim = (tid + 1 + (rng >> 8) % (team - 1)) % team;
+                DFSWorker<It> &vw = workers[victim];
+
+                omp_set_lock(&vw.lock);
+                size_t n = vw.stack.size();
+                if (n >= 2)
+                {
+                    loot.assign(vw.stack.begin(), vw.stack.begin() + n / 2);
+                    vw.stack.erase(vw.stack.begin(), vw.stack.begin() + n / 2);
+                    __atomic_sub_fetch(&idle, 1, __ATOMIC_ACQ_REL); // while the victim is still busy
+                }
+                omp_unset_lock(&vw.lock);
+
+                if (!loot.empty())
+                {
+                    omp_set_lock(&me.lock);
+                    me.stack.swap(loot);
+                    omp_unset_lock(&me.lock);
+                    loot.clear();
+                    active = true;
+                    continue;
+                }
+            }
+
+            // Everyone is idle: start the next tree from an unvisited vertex. Seeding only
+            // while no tree is in progress keeps exactly one tree per component
+            if (seedsLeft && __atomic_load_n(&idle, __ATOMIC_ACQUIRE) == team)
+            {
+#pragma omp critical(dfs_seed)
+                if (__atomic_load_n(&idle, __ATOMIC_ACQUIRE) == team)
+                {
+                    __atomic_sub_fetch(&idle, 1, __ATOMIC_ACQ_REL);
+                    while (!active && seedCursor < g.V)
+                    {
+                        int s = seedCursor;
+                        __atomic_store_n(&seedCursor, s + 1, __ATOMIC_RELAXED);
+                        if (!visited.test(s) && visited.claim(s))
+                        {
+                            discover(s, -1);
+                            omp_set_lock(&me.lock);
+                            me.stack.push_back({s, g.begin(s)});
+                            omp_unset_lock(&me.lock);
+                            active = true;
+                        }
+                    }
+                    if (!active)
+                        __atomic_add_fetch(&idle, 1, __ATOMIC_ACQ_REL);
+                }
+            }
+        }
+    }
+
+    for (DFSWorker<It> &w : workers)
+        omp_destroy_lock(&w.lock);
+
+    // Preorder and postorder: bucket the vertices by discovery and by finish time, then
+    // drop the empty slots
+    std::vector<int> byTime(2 * reached, -1);
+    for (int v = 0; v < g.V; v++)
+        if (r.discovery[v] >= 0)
+            byTime[r.discovery[v]] = v;
+    r.order.clear();
+    for (int v : byTime)
+        if (v >= 0)
+            r.order.push_back(v);
+
+    std::fill(byTime.begin(), byTime.end(), -1);
+    for (int v = 0; v < g.V; v++)
+        if (r.finish[v] >= 0)
+            byTime[r.finish[v]] = v;
+    r.postorder.clear();
+    for (int v : byTime)
+        if (v >= 0)
+            r.postorder.push_back(v);
+}
+
+template <class G>
+DFSResult parallelDFS(const G &g, int start, bool wholeGraph = false)
+{
+    DFSResult r;
+    parallelDFS(g, start, r, wholeGraph);
+    return r;
+}
+
+// Returns false if a visitor hook stopped the search. With wholeGraph, trees are started
+// from start and then from every still undiscovered vertex in id order.
+template <class G, class Visitor>
+bool sequentialDFS(const G &g, int start, DFSResult &r, Visitor &visit, bool wholeGraph = false)
+{
+    typedef decltype(g.begin(0)) It;
+
+    r.parent.assign(g.V, -1);
+    r.depth.assign(g.V, -1);
+    r.discovery.assign(g.V, -1);
+    r.finish.assign(g.V, -1);
+    r.order.clear();
+    r.postorder.clear();
+
+    std::vector<DFSFrame<It>> stack;
+    int64_t clock = 0;
+    int seedCursor = 0;
+
+    for (int root = start; root >= 0;)
+    {
+        r.depth[root] = 0;
+        r.discovery[root] = clock++;
+        r.order.push_back(root);
+        if (!visit.discover(root))
+            return false;
+        stack.push_back({root, g.begin(root)});
+
+        while (!stack.empty())
+        {
+            DFSFrame<It> &f = stack.back();
+            int u = f.v, child = -1;
+            for (It end = g.end(u); f.next != end;)
+            {
+                int v = *f.next;
+                ++f.next;
+                DFSEdgeType type = r.discovery[v] < 0               ? TreeEdge
+                                   : r.finish[v] < 0                ? BackEdge
+                                   : r.discovery[u] < r.discovery[v] ? ForwardEdge
+                                                                     : CrossEdge;
+                if (!visit.edge(u, v, type))
+                    return false;
+                if (type == TreeEdge)
+                {
+                    child = v;
+                    break;
+                }
+            }
+
+            if (child >= 0)
+            {
+                r.parent[child] = u;
+                r.depth[child] = r.depth[u] + 1;
+                r.discovery[child] = clock++;
+                r.order.push_back(child);
+                if (!visit.discover(child))
+                    return false;
+                stack.push_back({child, g.begin(child)}); // f is invalid from here on
+            }
+            else
+            {
+                stack.pop_back();
+                r.finish[u] = clock++;
+                r.postorder.push_back(u);
+                if (!visit.finish(u))
+                    return false;
+            }
+        }
+
+        root = -1;
+        while (wholeGraph && root < 0 && seedCursor < g.V)
+            if (r.discovery[seedCursor++] < 0)
+                root = seedCursor - 1;
+    }
+    return true;
+}
+
+template <class G>
+DFSResult sequentialDFS(const G &g, int start, bool wholeGraph = false)
+{
+    DFSResult r;
+    DFSVisitor none;
+    sequentialDFS(g, start, r, none, wholeGraph);
+    return r;
+}
+
+#endif
@@ -0,0 +1,273 @@
+/*
+ * Problem Statement:
+ * Run BFS on a graph that is split across several processes (partitioned_bfs.h), as a
+ * stand-in for a cluster run: the processes share nothing but a Transport (transport.h),
+ * shared memory or Unix sockets on one Linux machine.
+ *
+ * Every process generates only its slice of the R-MAT edge stream (generators.h), the
+ * slices are routed to the processes that store them (1D or 2D partitioning) and a few
+ * random roots are searched. For every search, rank 0 reports the time, the TEPS, the
+ * bytes sent between processes and the direction of every level. Unless --no-check is
+ * given, rank 0 also builds the whole graph and checks every search against a
+ * sequential BFS.
+ *
+ * How to run:
+ * 1. Open terminal in the directory containing the file (partitioned_bfs.h, transport.h,
+ *    bfs.h, graph.h, generators.h next to it)
+ * 2. Compile: g++ -O2 -fopenmp distributed_bfs.cpp -o distributed_bfs
+ * 3. Run: ./distributed_bfs [--procs 4] [--partition 1d|2d] [--transport shm|socket]
+ *                           [--scale 16] [--edgefactor 16] [--roots 4] [--seed 1]
+ *                           [--threads 1] [--no-bottom-up] [--no-check]
+ *    --threads is the number of OpenMP threads in every process
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <omp.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "partitioned_bfs.h"
+#include "transport.h"
+#include "bfs.h"
+#include "generators.h"
+
+using namespace std;
+
+struct RunOptions
+{
+    int procs = 4;
+    bool twoD = false;
+    bool sockets = false;
+    int scale = 16;
+    int edgeFactor = 16;
+    int roots = 4;
+    uint64_t seed = 1;
+    int threads = 1;
+    bool bottomUp = true;
+    bool check = true;
+};
+
+bool parseArgs(int argc, char *argv[], RunOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        string key = argv[i];
+        if (key == "--no-check")
+        {
+            opt.check = false;
+            continue;
+        }
+        if (key == "--no-bottom-up")
+        {
+            opt.bottomUp = false;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        string value = argv[++i];
+        if (key == "--procs")
+            opt.procs = atoi(value.c_str());
+        else if (key == "--partition" && (value == "1d" || value == "2d"))
+            opt.twoD = value == "2d";
+        else if (key == "--transport" && (value == "shm" || value == "socket"))
+            opt.sockets = value == "socket";
+        else if (key == "--scale")
+            opt.scale = atoi(value.c_str());
+        else if (key == "--edgefactor")
+            opt.edgeFactor = atoi(value.c_str());
+        else if (key == "--roots")
+            opt.roots = atoi(value.c_str());
+        else if (key == "--seed")
+            opt.seed = strtoull(value.c_str(), nullptr, 10);
+        else if (key == "--threads")
+            opt.threads = atoi(value.c_str());
+        else
+            return false;
+    }
+    return opt.procs >= 1 && opt.scale >= 1 && opt.scale <= 30 && opt.edgeFactor >= 1 &&
+           opt.roots >= 1 && opt.threads >= 1;
+}
+
+double peakMemoryMB()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024.0; // kilobytes on Linux
+}
+
+// Collects level and parent of every vertex on rank 0 (empty on the other ranks)
+void gatherOnRoot(Transport &t, const Partition &part, const PartitionedBFSResult &r,
+                  vector<int> &level, vector<int> &parent)
+{
+    MessageBuffers send(t.size()), recv;
+    appendInts(send[0], r.level.data(), r.level.size());
+    appendInts(send[0], r.parent.data(), r.parent.size());
+    t.exchange(send, recv);
+    if (t.rank() != 0)
+        return;
+
+    level.assign(part.V, -1);
+    parent.assign(part.V, -1);
+    for (int s = 0; s < t.size(); s++)
+    {
+        int64_t lo = part.lo(s), n = part.hi(s) - lo;
+        memcpy(level.data() + lo, recv[s].data(), n * sizeof(int));
+        memcpy(parent.data() + lo, recv[s].data() + n * sizeof(int), n * sizeof(int));
+    }
+}
+
+// Levels must equal a sequential BFS; every parent must be a neighbor one level up
+bool validate(const Graph &g, int root, const vector<int> &level, const vector<int> &parent)
+{
+    BFSResult ref = levelSyncBFS(g, root);
+    for (int v = 0; v < g.V; v++)
+    {
+        if (level[v] != ref.level[v])
+            return false;
+        if (v == root || level[v] < 0)
+            continue;
+        int p = parent[v];
+        if (p < 0 || p >= g.V || level[p] != level[v] - 1 || find(g.begin(v), g.end(v), p) == g.end(v))
+            return false;
+    }
+    return true;
+}
+
+int runRank(Transport &t, int rank, const RunOptions &opt)
+{
+    t.attach(rank);
+    omp_set_num_threads(opt.threads);
+    int P = t.size();
+    int V = 1 << opt.scale;
+    int64_t m = (int64_t)opt.edgeFactor * V;
+    Partition part(V, P, opt.twoD);
+
+    double t0 = omp_get_wtime();
+    LocalGraph g;
+    {
+        EdgeList slice = rmatEdgeRange(opt.scale, m * rank / P, m * (rank + 1) / P, opt.seed);
+        g = buildLocalGraph(t, part, slice);
+    }
+    int64_t entries = t.allreduceSum(g.numEntries());
+    int64_t maxLocal = t.allreduceMax(g.memoryBytes());
+    t.barrier();
+    double buildTime = omp_get_wtime() - t0;
+
+    Graph whole;
+    if (rank == 0)
+    {
+        cout << "R-MAT scale " << opt.scale << ", edge factor " << opt.edgeFactor << ": " << V << " vertices, "
+             << entries / 2 << " edges without duplicates" << endl;
+        cout << P << " processes, " << part.R << " x " << part.C << " grid, "
+             << (opt.sockets ? "Unix socket" : "shared memory") << " transport, " << opt.threads
+             << " thread(s) each" << endl;
+        cout << "Distributed build: " << buildTime << " s, largest local graph " << maxLocal / (1024.0 * 1024.0)
+             << " MB (whole CSR: " << (entries * 4 + (V + 1) * 8.0) / (1024.0 * 1024.0) << " MB)" << endl;
+        if (opt.check)
+            whole = Graph::fromEdges(V, rmatEdges(opt.scale, opt.edgeFactor, V, opt.seed));
+    }
+
+    PartitionedBFSOptions bopt;
+    bopt.bottomUp = opt.bottomUp;
+    PartitionedBFSResult r;
+    vector<int> level, parent;
+    double inverseTeps = 0, bytesTotal = 0;
+    int searched = 0;
+    bool ok = true;
+    uint64_t x = opt.seed ^ 0x5EED;
+
+    // Same root sequence on every rank; roots without edges are skipped
+    for (int attempt = 0; searched < opt.roots && attempt < 100 * opt.roots; attempt++)
+    {
+        int root = (int)(splitmix64(x) % V);
+        t.barrier();
+        t0 = omp_get_wtime();
+        partitionedBFS(t, part, g, root, r, bopt);
+        double seconds = omp_get_wtime() - t0;
+        if (r.reached == 1)
+            continue;
+        searched++;
+
+        bool valid = true;
+        if (opt.check)
+        {
+            gatherOnRoot(t, part, r, level, parent);
+            if (rank == 0)
+                valid = validate(whole, root, level, parent);
+        }
+        if (rank != 0)
+            continue;
+
+        double teps = r.edges / seconds;
+        inverseTeps += 1 / teps;
+        bytesTotal += r.bytes;
+        ok = ok && valid;
+        cout << "root " << root << ": " << r.reached << " vertices, " << r.direction.size() << " levels ("
+             << string(r.direction.begin(), r.direction.end()) << "), " << seconds << " s, " << teps / 1e6
+             << " MTEPS, " << r.bytes / (1024.0 * 1024.0) << " MB sent"
+             << (opt.check ? (valid ? ", valid" : ", INVALID") : "") << endl;
+    }
+
+    if (rank == 0)
+    {
+        if (searched > 0)
+            cout << "Harmonic mean " << searched / inverseTeps / 1e6 << " MTEPS, "
+                 << bytesTotal / searched / (1024.0 * 1024.0) << " MB sent per search" << endl;
+        cout << "Peak memory of rank 0: " << peakMemoryMB() << " MB" << endl;
+    }
+    return ok ? 0 : 2;
+}
+
+int main(int argc, char *argv[])
+{
+    RunOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        cout << "Usage: " << argv[0] << " [--procs 4] [--partition 1d|2d] [--transport shm|socket]"
+             << " [--scale 16] [--edgefactor 16] [--roots 4] [--seed 1] [--threads 1]"
+             << " [--no-bottom-up] [--no-check]" << endl;
+        return 1;
+    }
+
+    // The transport is set up before fork() so that every process inherits it. No
+    // OpenMP region may run before the fork: the children would inherit a broken pool.
+    SharedMemoryTransport shm;
+    SocketTransport sock;
+    Transport &t = opt.sockets ? (Transport &)sock : (Transport &)shm;
+    if (!(opt.sockets ? sock.create(opt.procs) : shm.create(opt.procs)))
+    {
+        perror("transport");
+        return 1;
+    }
+
+    cout.flush();
+    vector<pid_t> children;
+    for (int rank = 1; rank < opt.procs; rank++)
+    {
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0)
+            exit(runRank(t, rank, opt));
+        children.push_back(pid);
+    }
+
+    int status = runRank(t, 0, opt);
+    for (pid_t pid : children)
+    {
+        int childStatus;
+        waitpid(pid, &childStatus, 0);
+        if (!WIFEXITED(childStatus) || WEXITSTATUS(childStatus) != 0)
+            status = status ? status : 1;
+    }
+    return status;
+}
@@ -0,0 +1,270 @@
+/*
+ * Dynamic graph with cheap batched edge insertion, and BFS levels maintained
+ * incrementally from a fixed root.
+ *
+ * DynamicGraph
+ *   Same addEdge() / build() usage as Graph (graph.h), but build() can be called again
+ *   and again. Every neighbor list is a chain of 64-byte blocks (one cache line, 14
+ *   neighbors each) taken from one shared pool, so inserting a batch of m edges costs
+ *   O(m log m) for grouping them by vertex, independent of V and E: no CSR rebuild.
+ *   Large batches append to the touched vertices in parallel; every vertex's new blocks
+ *   get their slots from a prefix sum, so no locks are needed.
+ *
+ * IncrementalBFS
+ *   BFS levels and parents from a fixed root. refresh(g) after each build() only
+ *   inserts edges, so levels can only decrease:
+ *     1. every new edge (a, b) with level[a] + 1 < level[b] seeds b at level[a] + 1,
+ *     2. the decreases are propagated level by level in increasing order, exactly like
+ *        levelSyncBFS (bfs.h): a frontier of the vertices that just got level d expands
+ *        in parallel, an atomic min claims every neighbor that can move to d + 1, and
+ *        per-thread buffers are concatenated with a prefix sum.
+ *   Only vertices whose level decreases are ever expanded, so the cost of a refresh is
+ *   proportional to the affected region, not to V + E. If batches were skipped the
+ *   levels are recomputed from scratch.
+ */
+
+#ifndef DYNAMIC_H
+#define DYNAMIC_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+struct EdgeBlock
+{
+    int count;     // neighbors used in this block
+    int next;      // next block of the same vertex, -1 at the end
+    int items[14];
+};
+
+struct DynamicGraph
+{
+    int V;
+    std::vector<int> head, tail;  // first and last block of every vertex, -1 if none
+    std::vector<int> deg;
+    std::vector<EdgeBlock> blocks;
+    std::vector<std::pair<int, int>> pending;    // edges added since the last build()
+    std::vector<std::pair<int, int>> lastBatch;  // edges merged by the last build()
+    int64_t edges = 0;                           // directed entries (2E)
+    int64_t version = 0;                         // number of build() calls so far
+
+    DynamicGraph(int V = 0) : V(V), head(V, -1), tail(V, -1), deg(V, 0) {}
+
+    void addEdge(int u, int v)
+    {
+        pending.push_back({u, v}); // Undirected graph, both directions added by build()
+    }
+
+    // Appends the pending edges to the block chains; ids >= V add vertices
+    void build()
+    {
+        lastBatch.swap(pending);
+        pending.clear();
+        version++;
+
+        // Both directions of every edge, grouped by source vertex
+        std::vector<std::pair<int, int>> entries;
+        entries.reserve(2 * lastBatch.size());
+        int maxId = V - 1;
+        for (const std::pair<int, int> &e : lastBatch)
+        {
+            entries.push_back({e.first, e.second});
+            entries.push_back({e.second, e.first});
+            maxId = std::max(maxId, std::max(e.first, e.second));
+        }
+        std::sort(entries.begin(), entries.end());
+        if (maxId >= V)
+        {
+            V = maxId + 1;
+            head.resize(V, -1);
+            tail.resize(V, -1);
+            deg.resize(V, 0);
+        }
+
+        std::vector<int64_t> groupStart;
+        for (size_t i = 0; i < entries.size(); i++)
+            if (i == 0 || entries[i].first != entries[i - 1].first)
+                groupStart.push_back(i);
+        groupStart.push_back(entries.size());
+        int groups = (int)groupStart.size() - 1;
+
+        // New blocks per touched vertex, then one prefix sum hands out the block ids
+        std::vector<int64_t> firstNew(groups + 1, 0);
+#pragma omp parallel for if(groups > 4096)
+        for (int k = 0; k < groups; k++)
+        {
+            int u = entries[groupStart[k]].first;
+            int64_t count = groupStart[k + 1] - groupStart[k];
+            int64_t room = tail[u] < 0 ? 0 : 14 - blocks[tail[u]].count;
+            firstNew[k + 1] = count > room ? (count - room + 13) / 14 : 0;
+        }
+        for (int k = 0; k < groups; k++)
+            firstNew[k + 1] += firstNew[k];
+        int64_t base = blocks.size();
+        blocks.resize(base + firstNew[groups]);
+
+#pragma omp parallel for schedule(dynamic, 64) if(groups > 4096)
+        for (int k = 0; k < groups; k++)
+        {
+            int u = entries[groupStart[k]].first;
+            int fresh = (int)(base + firstNew[k]);
+            for (int64_t i = groupStart[k]; i < groupStart[k + 1]; i++)
+            {
+                if (tail[u] < 0 || blocks[tail[u]].count == 14)
+                {
+                    EdgeBlock &b = blocks[fresh];
+                    b.count = 0;
+                    b.next = -1;
+                    if (tail[u] < 0)
+                        head[u] = fresh;
+                    else
+                        blocks[tail[u]].next = fresh;
+                    tail[u] = fresh++;
+                }
+                EdgeBlock &b = blocks[tail[u]];
+                b.items[b.count++] = entries[i].second;
+            }
+            deg[u] += (int)(groupStart[k + 1] - groupStart[k]);
+        }
+        edges += entries.size();
+    }
+
+    int degree(int u) const { return deg[u]; }
+    int64_t numEdges() const { return edges; }
+
+    // Calls f(v) for every neighbor v of u
+    template <class F>
+    void forEachNeighbor(int u, F f) const
+    {
+        for (int b = head[u]; b >= 0; b = blocks[b].next)
+            for (int i = 0; i < blocks[b].count; i++)
+                f(blocks[b].items[i]);
+    }
+
+    size_t memoryBytes() const
+    {
+        return blocks.size() * sizeof(EdgeBlock) + 3 * (size_t)V * sizeof(int);
+    }
+};
+
+struct IncrementalBFS
+{
+    int root;
+    std::vector<int> level;   // distance from root, -1 if unreached
+    std::vector<int> parent;  // BFS tree parent, -1 for root and unreached vertices
+    int64_t seenVersion = -1; // graph version the levels are valid for
+    int64_t lastAffected = 0; // vertices whose level changed in the last refresh
+
+    IncrementalBFS(int root = 0) : root(root) {}
+
+    // Brings the levels up to date with g
+    void refresh(const DynamicGraph &g)
+    {
+        // Seeds: (new level, vertex, parent)
+        std::vector<std::pair<int, std::pair<int, int>>> seeds;
+        if (seenVersion < 0 || g.version != seenVersion + 1 || root >= (int)level.size())
+        {
+            level.assign(g.V, -1);
+            parent.assign(g.V, -1);
+            if (root < g.V)
+                seeds.push_back({0, {root, -1}});
+        }
+        else
+        {
+            level.resize(g.V, -1);
+            parent.resize(g.V, -1);
+            for (const std::pair<int, int> &e : g.lastBatch)
+                for (int side = 0; side < 2; side++)
+                {
+                    int a = side ? e.second : e.first, b = side ? e.first : e.second;
+                    if (level[a] >= 0 && (unsigned)(level[a] + 1) < (unsigned)level[b])
+                        seeds.push_back({level[a] + 1, {b, a}});
+                }
+        }
+        seenVersion = g.version;
+        lastAffected = 0;
+        if (seeds.empty())
+            return;
+
+        // Lowest candidate first; a vertex keeps the smallest level it is offered
+        std::sort(seeds.begin(), seeds.end());
+        for (const auto &s : seeds)
+            if ((unsigned)s.first < (unsigned)level[s.second.first])
+            {
+                level[s.second.first] = s.first;
+                parent[s.second.first] = s.second.second;
+            }
+
+        std::vector<int> frontier, next;
+        std::vector<int64_t> writeAt;
+        size_t si = 0;
+        int d = seeds[0].first;
+
+        while (true)
+        {
+            // Seeds join the frontier at their level, unless propagation lowered them since
+            for (; si < seeds.size() && seeds[si].first == d; si++)
+            {
+                int v = seeds[si].second.first;
+                if (level[v] == d && (frontier.empty() || frontier.back() != v))
+                    frontier.push_back(v);
+            }
+            if (frontier.empty())
+            {
+                if (si == seeds.size())
+                    break;
+                d = seeds[si].first;
+                continue;
+            }
+            lastAffected += frontier.size();
+
+            // Expand the frontier: claim every neighbor whose level can drop to d + 1
+            int64_t width = frontier.size();
+#pragma omp parallel if(width > 1024)
+            {
+                int tid = omp_get_thread_num(), nthreads = omp_get_num_threads();
+                std::vector<int> local;
+
+#pragma omp single
+                writeAt.assign(nthreads + 1, 0);
+
+#pragma omp for schedule(dynamic, 64)
+                for (int64_t i = 0; i < width; i++)
+                {
+                    int u = frontier[i];
+                    g.forEachNeighbor(u, [&](int v)
+                    {
+                        unsigned old = __atomic_load_n((unsigned *)&level[v], __ATOMIC_RELAXED);
+                        while ((unsigned)(d + 1) < old)
+                        {
+                            if (__atomic_compare_exchange_n((unsigned *)&level[v], &old, (unsigned)(d + 1), true,
+                                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                            {
+                                parent[v] = u;
+                                local.push_back(v);
+                                break;
+                            }
+                        }
+                    });
+                }
+
+                writeAt[tid + 1] = local.size();
+#pragma omp barrier
+#pragma omp single
+                {
+                    for (int t = 0; t < nthreads; t++)
+                        writeAt[t + 1] += writeAt[t];
+                    next.resize(writeAt[nthreads]);
+                }
+                std::copy(local.begin(), local.end(), next.begin() + writeAt[tid]);
+            }
+
+            frontier.swap(next);
+            d++;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*
+ * Synthetic graph generators for benchmarking the traversal engines.
+ *
+ * Every generator returns an undirected edge list (pairs of vertex ids) and sets V.
+ * Edges are generated in parallel, each into a slot fixed by its index (the random
+ * generators seed one stream per edge or per cycle), so the output does not depend on
+ * the thread count. Only the vertex permutations of rmat and regular are sequential.
+ *
+ *   rmatEdges(scale, edgeFactor)  R-MAT / Kronecker with the Graph500 parameters
+ *                                 A = 0.57, B = 0.19, C = 0.19, vertex ids permuted
+ *   rmatEdgeRange(scale, first, last)  one slice of the same R-MAT edge stream
+ *   grid2DEdges(side)             side x side 4-neighbor grid (high diameter)
+ *   grid3DEdges(side)             side^3 6-neighbor grid
+ *   randomRegularEdges(V, d)      union of d/2 random Hamiltonian cycles: degree d,
+ *                                 counting repeated edges (see below)
+ *   chainEdges(V)                 a single path (maximum depth)
+ *   wideTreeEdges(V, fanout)      complete fanout-ary tree (very wide levels)
+ *
+ *   edgeWeight(u, v)              deterministic weight in [1, 100), the same for (v, u)
+ */
+
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+typedef std::vector<std::pair<int, int>> EdgeList;
+
+// SplitMix64: small, fast, and good enough to seed one stream per edge
+inline uint64_t splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+inline double uniform01(uint64_t &x)
+{
+    return (splitmix64(x) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Random permutation of 0 .. n - 1 (sequential Fisher-Yates)
+inline std::vector<int> randomPermutation(int n, uint64_t seed)
+{
+    std::vector<int> p(n);
+    for (int i = 0; i < n; i++)
+        p[i] = i;
+    for (int i = n - 1; i > 0; i--)
+        std::swap(p[i], p[splitmix64(seed) % (i + 1)]);
+    return p;
+}
+
+// Edges first .. last - 1 of the R-MAT stream of rmatEdges(): any slice of the edge list
+// can be generated on its own, e.g. one slice per process (distributed_bfs.cpp)
+inline EdgeList rmatEdgeRange(int scale, int64_t first, int64_t last, uint64_t seed = 1)
+{
+    const double A = 0.57, B = 0.19, C = 0.19;
+    int V = 1 << scale;
+    int64_t m = last - first;
+    EdgeList edges(m);
+
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < m; i++)
+    {
+        uint64_t x = seed * 0x2545F4914F6CDD1DULL + first + i;
+        int u = 0, v = 0;
+        for (int bit = 0; bit < scale; bit++)
+        {
+            double r = uniform01(x);
+            int down = r >= A + B;                          // quadrant C or D
+            int right = (r >= A && r < A + B) || r >= A + B + C; // quadrant B or D
+            u |= down << bit;
+            v |= right << bit;
+        }
+        edges[i] = {u, v};
+    }
+
+    // Scramble the ids so that high-degree vertices are not clustered at low ids
+    std::vector<int> perm = randomPermutation(V, seed ^ 0xC0FFEE);
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < m; i++)
+        edges[i] = {perm[edges[i].first], perm[edges[i].second]};
+    return edges;
+}
+
+inline EdgeList rmatEdges(int scale, int edgeFactor, int &V, uint64_t seed = 1)
+{
+    V = 1 << scale;
+    return rmatEdgeRange(scale, 0, (int64_t)edgeFactor * V, seed);
+}
+
+// Row by row, every vertex's right edge then its down edge; each row starts at a
+// position known in advance, so the rows are filled in parallel
+inline EdgeList grid2DEdges(int side, int &V)
+{
+    V = side * side;
+    if (side <= 0)
+        return EdgeList();
+    const int64_t rowEdges = 2 * (int64_t)side - 1; // every row but the last
+    EdgeList edges((int64_t)(side - 1) * rowEdges + side - 1);
+
+#pragma omp parallel for schedule(static)
+    for (int r = 0; r < side; r++)
+    {
+        int64_t at = r * rowEdges;
+        for (int c = 0; c < side; c++)
+        {
+            int u = r * side + c;
+            if (c + 1 < side)
+                edges[at++] = {u, u + 1};
+            if (r + 1 < side)
+                edges[at++] = {u, u + side};
+        }
+    }
+    return edges;
+}
+
+// Same order as grid2DEdges with a third (plane) edge per vertex; one parallel row each
+inline EdgeList grid3DEdges(int side, int &V)
+{
+    V = side * side * side;
+    if (side <= 0)
+        return EdgeList();
+    const int64_t s = side;
+    const int64_t inPlane = 2 * s * (s - 1);     // right and down edges of one plane
+    const int64_t planeEdges = inPlane + s * s;  // every plane but the last
+    EdgeList edges((s - 1) * planeEdges + inPlane);
+
+#pragma omp parallel for collapse(2) schedule(static)
+    for (int z = 0; z < side; z++)
+        for (int r = 0; r < side; r++)
+        {
+            int64_t rowEdges = (s - 1) + s + (z + 1 < side ? s : 0); // rows but the last
+            int64_t at = z * planeEdges + r * rowEdges;
+            for (int c = 0; c < side; c++)
+            {
+                int u = (z * side + r) * side + c;
+                if (c + 1 < side)
+                    edges[at++] = {u, u + 1};
+                if (r + 1 < side)
+                    edges[at++] = {u, u + side};
+                if (z + 1 < side)
+                    edges[at++] = {u, u + side * side};
+            }
+        }
+    return edges;
+}
+
+// Cycle k fills edges[k * n .. (k + 1) * n), one cycle per thread. The cycles are
+// independent, so two of them can share an edge and n < 3 gives self-loops and
+// repeats: the list may contain multi-edges, which BuildOptions::removeDuplicates and
+// removeSelfLoops drop (the graph is then only approximately d-regular).
+inline EdgeList randomRegularEdges(int n, int degree, uint64_t seed = 1)
+{
+    int cycles = degree / 2;
+    EdgeList edges((int64_t)n * cycles);
+
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int k = 0; k < cycles; k++)
+    {
+        std::vector<int> p = randomPermutation(n, seed + k);
+        for (int i = 0; i < n; i++)
+            edges[(int64_t)k * n + i] = {p[i], p[(i + 1) % n]};
+    }
+    return edges;
+}
+
+inline EdgeList chainEdges(int n)
+{
+    EdgeList edges(n > 0 ? n - 1 : 0);
+#pragma omp parallel for
+    for (int i = 0; i < n - 1; i++)
+        edges[i] = {i, i + 1};
+    return edges;
+}
+
+inline EdgeList wideTreeEdges(int n, int fanout)
+{
+    EdgeList edges(n > 0 ? n - 1 : 0);
+#pragma omp parallel for
+    for (int i = 1; i < n; i++)
+        edges[i - 1] = {(i - 1) / fanout, i};
+    return edges;
+}
+
+// Weight of the undirected edge {u, v}: hashed from the pair, so both stored
+// directions agree and the weights do not depend on the thread count
+inline float edgeWeight(int u, int v, uint64_t seed = 1)
+{
+    uint64_t x = seed ^ ((uint64_t)std::min(u, v) << 32 | (uint32_t)std::max(u, v));
+    return 1 + 99 * (float)uniform01(x);
+}
+
+#endif
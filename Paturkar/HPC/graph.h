@@ -0,0 +1,400 @@
+/*
+ * Compressed Sparse Row (CSR) graph shared by the Paturkar/HPC traversal programs.
+ *
+ * Usage:
+ *   #include "graph.h"   (keep this file next to the .cpp that includes it)
+ *   Graph g(V);
+ *   g.addEdge(u, v);     // staged, cheap
+ *   g.build();           // one parallel bulk pass turns the staged edges into CSR
+ *
+ *   Graph f = Graph::fromEdges(V, edgeArray, m, opt);  // straight from a flat edge array
+ *
+ *   Graph h;
+ *   loadSnapshot("graph.csr", h);  // memory-maps a binary snapshot, no parsing (one
+ *                                  // parallel pass validates offsets and neighbor ids)
+ *
+ * Layout:
+ *   offsets[V + 1]  - neighbors of u live in neighbors[offsets[u] .. offsets[u + 1])
+ *   neighbors[2E]   - every undirected edge is stored in both directions
+ *
+ * Each vertex's neighbor list is one contiguous slice of a single array, so a
+ * neighbor scan is a sequential, prefetch-friendly stream and there is no
+ * per-vertex heap allocation or vector header.
+ *
+ * offsets/neighbors are plain pointers: they point either into the graph's own
+ * vectors (after build()) or straight into a memory-mapped snapshot file.
+ *
+ * Snapshot file format (little-endian, written by saveSnapshot()):
+ *   char    magic[8]      "CSRGRAPH"
+ *   uint32  version       1
+ *   uint32  reserved      0
+ *   int64   V
+ *   int64   numEdges      directed entries (2E)
+ *   int64   offsets[V + 1]
+ *   int32   neighbors[numEdges]
+ */
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// In-place inclusive prefix sum of a[0 .. n): each thread scans its own block, then
+// adds the total of the blocks before it
+inline void parallelPrefixSum(int64_t *a, int64_t n)
+{
+    std::vector<int64_t> blockSum(omp_get_max_threads() + 1, 0);
+
+#pragma omp parallel num_threads(blockSum.size() - 1)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        int64_t lo = n * t / nt, hi = n * (t + 1) / nt;
+
+        int64_t sum = 0;
+        for (int64_t i = lo; i < hi; i++)
+            a[i] = sum += a[i];
+        blockSum[t + 1] = sum;
+
+#pragma omp barrier
+#pragma omp single
+        for (int i = 1; i <= nt; i++)
+            blockSum[i] += blockSum[i - 1];
+
+        for (int64_t i = lo; i < hi; i++)
+            a[i] += blockSum[t];
+    }
+}
+
+// Optional clean-up passes for build() / fromEdges()
+struct BuildOptions
+{
+    bool removeSelfLoops = false;  // drop edges (u, u)
+    bool removeDuplicates = false; // keep one copy of repeated edges (implies sorted lists)
+    bool sortNeighbors = false;    // sort every neighbor list by vertex id
+};
+
+struct Graph
+{
+    int V;
+    const int64_t *offsets;                    // size V + 1
+    const int *neighbors;                      // size offsets[V]
+    std::vector<std::pair<int, int>> pending;  // edges added since the last build()
+
+    std::vector<int64_t> offsetStore;          // owned arrays (empty when mapped)
+    std::vector<int> neighborStore;
+    std::shared_ptr<void> mapping;             // keeps a mapped snapshot alive
+
+    Graph(int V = 0)
+    {
+        this->V = V;
+        offsetStore.assign(V + 1, 0);
+        rebind();
+    }
+
+    Graph(const Graph &other)
+        : V(other.V), offsets(other.offsets), neighbors(other.neighbors), pending(other.pending),
+          offsetStore(other.offsetStore), neighborStore(other.neighborStore), mapping(other.mapping)
+    {
+        if (!mapping)
+            rebind();
+    }
+
+    Graph(Graph &&other) = default; // vector buffers move with their pointers
+
+    Graph &operator=(Graph other)
+    {
+        std::swap(V, other.V);
+        std::swap(offsets, other.offsets);
+        std::swap(neighbors, other.neighbors);
+        pending.swap(other.pending);
+        offsetStore.swap(other.offsetStore);
+        neighborStore.swap(other.neighborStore);
+        mapping.swap(other.mapping);
+        return *this;
+    }
+
+    // Builds a graph in one parallel pass from an undirected edge list
+    static Graph fromEdges(int V, const std::vector<std::pair<int, int>> &edges,
+                           const BuildOptions &opt = BuildOptions())
+    {
+        return fromEdges(V, edges.data(), edges.size(), opt);
+    }
+
+    static Graph fromEdges(int V, const std::pair<int, int> *edges, int64_t m,
+                           const BuildOptions &opt = BuildOptions())
+    {
+        Graph g(V);
+        g.merge(edges, m, opt);
+        return g;
+    }
+
+    void addEdge(int u, int v)
+    {
+        pending.push_back({u, v}); // Undirected graph, both directions added by build()
+    }
+
+    // Merges the pending edges into the CSR arrays
+    void build(const BuildOptions &opt = BuildOptions())
+    {
+        if (pending.empty() && !opt.sortNeighbors && !opt.removeDuplicates && !opt.removeSelfLoops)
+            return;
+        merge(pending.data(), pending.size(), opt);
+        std::vector<std::pair<int, int>>().swap(pending); // release staging memory
+    }
+
+    // Parallel CSR construction from the current arrays plus m new edges:
+    // 1. degree count (atomic increments), 2. prefix sum into offsets,
+    // 3. scatter through per-vertex atomic cursors, 4. optional per-vertex clean-up
+    void merge(const std::pair<int, int> *edges, int64_t m, const BuildOptions &opt)
+    {
+        std::vector<int64_t> newOffsets(V + 1, 0);
+
+#pragma omp parallel for
+        for (int u = 0; u < V; u++)
+            newOffsets[u + 1] = degree(u);
+
+#pragma omp parallel for
+        for (int64_t i = 0; i < m; i++)
+        {
+            int u = edges[i].first, v = edges[i].second;
+            if (u == v && opt.removeSelfLoops)
+                continue;
+            __atomic_fetch_add(&newOffsets[u + 1], 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&newOffsets[v + 1], 1, __ATOMIC_RELAXED);
+        }
+
+        parallelPrefixSum(newOffsets.data() + 1, V);
+
+        std::vector<int> newNeighbors(newOffsets[V]);
+        std::vector<int64_t> cursor(V);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int u = 0; u < V; u++)
+        {
+            int64_t pos = newOffsets[u];
+            for (const int *p = begin(u); p != end(u); ++p)
+                newNeighbors[pos++] = *p;
+            cursor[u] = pos;
+        }
+
+#pragma omp parallel for
+        for (int64_t i = 0; i < m; i++)
+        {
+            int u = edges[i].first, v = edges[i].second;
+            if (u == v && opt.removeSelfLoops)
+                continue;
+            newNeighbors[__atomic_fetch_add(&cursor[u], 1, __ATOMIC_RELAXED)] = v;
+            newNeighbors[__atomic_fetch_add(&cursor[v], 1, __ATOMIC_RELAXED)] = u;
+        }
+
+        if (opt.sortNeighbors || opt.removeDuplicates || opt.removeSelfLoops)
+        {
+            // Clean every neighbor list (this also covers edges from earlier builds),
+            // then compact the lists with a second prefix sum
+            std::vector<int64_t> kept(V + 1, 0);
+
+#pragma omp parallel for schedule(dynamic, 256)
+            for (int u = 0; u < V; u++)
+            {
+                int *first = newNeighbors.data() + newOffsets[u];
+                int *last = newNeighbors.data() + newOffsets[u + 1];
+                if (opt.sortNeighbors || opt.removeDuplicates)
+                    std::sort(first, last);
+                if (opt.removeDuplicates)
+                    last = std::unique(first, last);
+                if (opt.removeSelfLoops)
+                    last = std::remove(first, last, u);
+                kept[u + 1] = last - first;
+            }
+
+            parallelPrefixSum(kept.data() + 1, V);
+            if (kept[V] != newOffsets[V])
+            {
+                std::vector<int> compact(kept[V]);
+
+#pragma omp parallel for schedule(dynamic, 1024)
+                for (int u = 0; u < V; u++)
+                    std::copy(newNeighbors.begin() + newOffsets[u],
+                              newNeighbors.begin() + newOffsets[u] + (kept[u + 1] - kept[u]),
+                              compact.begin() + kept[u]);
+
+                newOffsets.swap(kept);
+                newNeighbors.swap(compact);
+            }
+        }
+
+        offsetStore.swap(newOffsets);
+        neighborStore.swap(newNeighbors);
+        mapping.reset();
+        rebind();
+    }
+
+    // Points offsets/neighbors at the owned vectors
+    void rebind()
+    {
+        offsets = offsetStore.data();
+        neighbors = neighborStore.data();
+    }
+
+    int degree(int u) const { return (int)(offsets[u + 1] - offsets[u]); }
+    int64_t numEdges() const { return offsets[V]; } // directed entries (2E)
+
+    const int *begin(int u) const { return neighbors + offsets[u]; }
+    const int *end(int u) const { return neighbors + offsets[u + 1]; }
+
+    size_t memoryBytes() const
+    {
+        return (V + 1) * sizeof(int64_t) + numEdges() * sizeof(int);
+    }
+};
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t V;
+    int64_t numEdges;
+};
+
+// Writes g as a binary snapshot that loadSnapshot() can map back in
+inline bool saveSnapshot(const Graph &g, const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    SnapshotHeader h;
+    memcpy(h.magic, "CSRGRAPH", 8);
+    h.version = 1;
+    h.reserved = 0;
+    h.V = g.V;
+    h.numEdges = g.numEdges();
+
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+              fwrite(g.offsets, sizeof(int64_t), g.V + 1, f) == (size_t)g.V + 1 &&
+              fwrite(g.neighbors, sizeof(int), h.numEdges, f) == (size_t)h.numEdges;
+    return fclose(f) == 0 && ok;
+}
+
+// Header sizes that fit a file of fileBytes bytes exactly, checked without overflow
+inline bool snapshotSizeMatches(const SnapshotHeader &h, uint64_t fileBytes)
+{
+    if (h.V < 0 || h.V >= INT32_MAX || h.numEdges < 0 || fileBytes < sizeof(h))
+        return false;
+    uint64_t rest = fileBytes - sizeof(h);
+    uint64_t offsetBytes = ((uint64_t)h.V + 1) * sizeof(int64_t); // V < 2^31: no overflow
+    if (rest < offsetBytes || (uint64_t)h.numEdges > (rest - offsetBytes) / sizeof(int))
+        return false;
+    return rest - offsetBytes == (uint64_t)h.numEdges * sizeof(int);
+}
+
+// offsets[0] == 0, offsets[V] == numEdges, offsets never decrease and every neighbor id
+// is in [0, V); checked in parallel, O(V + numEdges)
+inline bool validCSR(const int64_t *offsets, const int *neighbors, int64_t V, int64_t numEdges)
+{
+    if (offsets[0] != 0 || offsets[V] != numEdges)
+        return false;
+    int bad = 0;
+#pragma omp parallel for reduction(| : bad)
+    for (int64_t u = 0; u < V; u++)
+        bad |= offsets[u] > offsets[u + 1];
+    if (bad)
+        return false;
+#pragma omp parallel for reduction(| : bad)
+    for (int64_t i = 0; i < numEdges; i++)
+        bad |= (unsigned)neighbors[i] >= (unsigned)V;
+    return !bad;
+}
+
+// Loads a snapshot. On POSIX systems the file is mapped read-only and shared, so the
+// graph uses the page cache directly (zero copies, zero parsing) and processes that
+// load the same file share its pages. Elsewhere the arrays are read into memory.
+// Files whose sizes or offsets are inconsistent, or whose neighbor ids are out of
+// range, are rejected; g is left untouched then.
+inline bool loadSnapshot(const char *path, Graph &g)
+{
+    SnapshotHeader h;
+
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(h))
+    {
+        close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    void *base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping stays valid after the descriptor is closed
+    if (base == MAP_FAILED)
+        return false;
+    std::shared_ptr<void> mapping(base, [size](void *p) { munmap(p, size); });
+
+    memcpy(&h, base, sizeof(h));
+    if (memcmp(h.magic, "CSRGRAPH", 8) != 0 || h.version != 1 || !snapshotSizeMatches(h, size))
+        return false;
+
+    const char *data = (const char *)base + sizeof(h);
+    const int64_t *offsets = (const int64_t *)data;
+    const int *neighbors = (const int *)(data + (h.V + 1) * sizeof(int64_t));
+    if (!validCSR(offsets, neighbors, h.V, h.numEdges))
+        return false;
+
+    g = Graph();
+    g.V = (int)h.V;
+    g.offsets = offsets;
+    g.neighbors = neighbors;
+    g.offsetStore.clear();
+    g.mapping = mapping;
+#else
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return false;
+
+    // File size first, so a corrupt header cannot make the resizes below huge
+    int64_t fileBytes = -1;
+    if (_fseeki64(f, 0, SEEK_END) == 0)
+        fileBytes = _ftelli64(f);
+    bool ok = fileBytes >= 0 && _fseeki64(f, 0, SEEK_SET) == 0 && fread(&h, sizeof(h), 1, f) == 1 &&
+              memcmp(h.magic, "CSRGRAPH", 8) == 0 && h.version == 1 &&
+              snapshotSizeMatches(h, (uint64_t)fileBytes);
+    Graph loaded;
+    if (ok)
+    {
+        loaded.V = (int)h.V;
+        loaded.offsetStore.resize(h.V + 1);
+        loaded.neighborStore.resize(h.numEdges);
+        ok = fread(loaded.offsetStore.data(), sizeof(int64_t), h.V + 1, f) == (size_t)h.V + 1 &&
+             fread(loaded.neighborStore.data(), sizeof(int), h.numEdges, f) == (size_t)h.numEdges;
+    }
+    fclose(f);
+    if (!ok || !validCSR(loaded.offsetStore.data(), loaded.neighborStore.data(), h.V, h.numEdges))
+        return false;
+    loaded.rebind();
+    g = std::move(loaded);
+#endif
+
+    return true;
+}
+
+#endif
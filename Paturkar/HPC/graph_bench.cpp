@@ -0,0 +1,473 @@
+/*
+ * Problem Statement:
+ * Benchmark the traversal engines (bfs.h, dfs.h) on synthetic graphs from generators.h
+ * in a reproducible way, sweeping graph size, edge factor and thread count.
+ *
+ * For every generated graph, thread count and algorithm, a fixed set of random roots
+ * (vertices with at least one edge) is searched. Every run is validated against a
+ * sequential BFS (sssp: against sequential Dijkstra, with weights from edgeWeight()),
+ * and one record per run is written to stdout as CSV or JSON:
+ *   seconds        wall time of the traversal
+ *   teps           traversed edges per second: undirected edges inside the reached
+ *                  component / seconds (the Graph500 definition, after duplicate
+ *                  edges and self-loops are removed)
+ *   levels         BFS levels, DFS tree depth or delta-stepping buckets
+ *   level_seconds  wall time of every BFS level (empty for DFS and SSSP)
+ *   peak_rss_mb    peak resident memory of the process so far
+ *   valid          1 if the result passed validation
+ * With --compressed, BFS and DFS run on a CompressedGraph (compressed.h) instead of the
+ * plain CSR, and the compressed size is reported.
+ * A summary with the harmonic mean TEPS of every configuration (and the Dijkstra
+ * time for sssp) goes to stderr.
+ *
+ * Generators (--gen):
+ *   rmat     R-MAT / Kronecker, Graph500 parameters, 2^scale vertices, edgefactor * V edges
+ *   grid2d   2D grid with about 2^scale vertices
+ *   grid3d   3D grid with about 2^scale vertices
+ *   regular  random regular graph, degree = edgefactor (rounded down to even)
+ *   chain    a path of 2^scale vertices
+ *   tree     complete tree of 2^scale vertices, fanout = edgefactor
+ *
+ * How to run:
+ * 1. Open terminal in the directory containing the file (graph.h, bfs.h, dfs.h,
+ *    generators.h next to it)
+ * 2. Compile: g++ -O2 -fopenmp graph_bench.cpp -o graph_bench
+ * 3. Run: ./graph_bench [--gen rmat,grid2d,...] [--scale 16,18] [--edgefactor 16]
+ *                       [--threads 1,2,4] [--algo bfs,dobfs,dfs,seqdfs,sssp] [--roots 8]
+ *                       [--seed 1] [--format csv|json] [--compressed] > results.csv
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+#include "graph.h"
+#include "bfs.h"
+#include "dfs.h"
+#include "sssp.h"
+#include "compressed.h"
+#include "generators.h"
+
+using namespace std;
+
+struct BenchOptions
+{
+    vector<string> gens = {"rmat"};
+    vector<int> scales = {14};
+    vector<int> edgeFactors = {16};
+    vector<int> threads = {omp_get_max_threads()};
+    vector<string> algos = {"bfs", "dobfs", "dfs"};
+    int roots = 8;
+    uint64_t seed = 1;
+    bool json = false;
+    bool compressed = false;
+};
+
+struct RunRecord
+{
+    string gen, algo;
+    int scale, edgeFactor, V, threads, root, levels;
+    int64_t edges;
+    double seconds, teps, peakMB;
+    vector<double> levelSeconds;
+    bool valid;
+};
+
+vector<string> splitList(const char *s)
+{
+    vector<string> out;
+    stringstream ss(s);
+    string item;
+    while (getline(ss, item, ','))
+        if (!item.empty())
+            out.push_back(item);
+    return out;
+}
+
+vector<int> splitInts(const char *s)
+{
+    vector<int> out;
+    for (const string &item : splitList(s))
+        out.push_back(atoi(item.c_str()));
+    return out;
+}
+
+double peakMemoryMB()
+{
+#ifndef _WIN32
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss / 1024.0; // kilobytes on Linux
+#else
+    return 0;
+#endif
+}
+
+// Builds the requested graph; false for an unknown generator name
+bool generate(const string &gen, int scale, int edgeFactor, uint64_t seed, Graph &g)
+{
+    int V = 1 << scale;
+    EdgeList edges;
+    if (gen == "rmat")
+        edges = rmatEdges(scale, edgeFactor, V, seed);
+    else if (gen == "grid2d")
+        edges = grid2DEdges((int)lround(pow(2.0, scale / 2.0)), V);
+    else if (gen == "grid3d")
+        edges = grid3DEdges((int)lround(pow(2.0, scale / 3.0)), V);
+    else if (gen == "regular")
+        edges = randomRegularEdges(V, max(2, edgeFactor / 2 * 2), seed);
+    else if (gen == "chain")
+        edges = chainEdges(V);
+    else if (gen == "tree")
+        edges = wideTreeEdges(V, max(2, edgeFactor));
+    else
+        return false;
+
+    BuildOptions opt;
+    opt.removeSelfLoops = true;
+    opt.removeDuplicates = true;
+    g = Graph::fromEdges(V, edges, opt);
+    return true;
+}
+
+// Sequential reference BFS: levels only
+void referenceBFS(const Graph &g, int start, vector<int> &level)
+{
+    level.assign(g.V, -1);
+    vector<int> queue(1, start);
+    level[start] = 0;
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int u = queue[head];
+        for (const int *p = g.begin(u); p != g.end(u); ++p)
+            if (level[*p] < 0)
+            {
+                level[*p] = level[u] + 1;
+                queue.push_back(*p);
+            }
+    }
+}
+
+bool isNeighbor(const Graph &g, int u, int v)
+{
+    return find(g.begin(u), g.end(u), v) != g.end(u);
+}
+
+// Same levels as the reference, and every parent is an adjacent vertex one level up
+bool validateBFS(const Graph &g, int start, const BFSResult &r, const vector<int> &ref)
+{
+    if (r.level != ref || r.parent[start] != -1)
+        return false;
+    bool ok = true;
+#pragma omp parallel for reduction(&& : ok)
+    for (int v = 0; v < g.V; v++)
+    {
+        if (v == start || ref[v] < 0)
+            continue;
+        int p = r.parent[v];
+        ok = ok && p >= 0 && ref[p] == ref[v] - 1 && isNeighbor(g, v, p);
+    }
+    return ok;
+}
+
+// Same reached set as the reference, tree edges exist, and tree intervals nest
+bool validateDFS(const Graph &g, int start, const DFSResult &r, const vector<int> &ref, int64_t reached)
+{
+    if ((int64_t)r.order.size() != reached || r.order.empty() || r.order[0] != start)
+        return false;
+    bool ok = true;
+#pragma omp parallel for reduction(&& : ok)
+    for (int v = 0; v < g.V; v++)
+    {
+        if ((ref[v] >= 0) != (r.discovery[v] >= 0))
+        {
+            ok = false;
+            continue;
+        }
+        if (v == start || ref[v] < 0)
+            continue;
+        int p = r.parent[v];
+        ok = ok && p >= 0 && isNeighbor(g, v, p) && r.depth[v] == r.depth[p] + 1 &&
+             r.discovery[p] < r.discovery[v] && r.finish[v] < r.finish[p];
+    }
+    return ok;
+}
+
+// Same distances as Dijkstra, and every parent edge is tight: dist[p] + w(p, v) == dist[v]
+bool validateSSSP(const WeightedGraph &g, int source, const SSSPResult &r, const SSSPResult &ref)
+{
+    if (r.dist != ref.dist || r.parent[source] != -1)
+        return false;
+    bool ok = true;
+#pragma omp parallel for reduction(&& : ok)
+    for (int v = 0; v < g.V; v++)
+    {
+        if (v == source || r.parent[v] < 0)
+        {
+            ok = ok && (v == source || r.dist[v] == numeric_limits<float>::infinity());
+            continue;
+        }
+        int p = r.parent[v];
+        bool tight = false;
+        for (int64_t e = g.offsets[v]; e < g.offsets[v + 1] && !tight; e++)
+            tight = g.neighbors[e] == p && r.dist[p] + g.weights[e] == r.dist[v];
+        ok = ok && tight;
+    }
+    return ok;
+}
+
+// Random roots with at least one edge (any vertex if the graph has no edges)
+vector<int> pickRoots(const Graph &g, int count, uint64_t seed)
+{
+    vector<int> roots;
+    uint64_t x = seed;
+    bool anyEdge = g.numEdges() > 0;
+    for (int tries = 0; (int)roots.size() < count && tries < 64 * count; tries++)
+    {
+        int v = (int)(splitmix64(x) % g.V);
+        if (!anyEdge || g.degree(v) > 0)
+            roots.push_back(v);
+    }
+    return roots;
+}
+
+void printHeader(const BenchOptions &opt)
+{
+    if (opt.json)
+        printf("[\n");
+    else
+        printf("gen,scale,edgefactor,vertices,edges,threads,algo,root,seconds,teps,levels,level_seconds,peak_rss_mb,valid\n");
+}
+
+void printRecord(const BenchOptions &opt, const RunRecord &rec, bool first)
+{
+    string levels;
+    for (size_t i = 0; i < rec.levelSeconds.size(); i++)
+    {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%s%.3g", i ? (opt.json ? "," : ";") : "", rec.levelSeconds[i]);
+        levels += buf;
+    }
+
+    if (opt.json)
+        printf("%s  {\"gen\": \"%s\", \"scale\": %d, \"edgefactor\": %d, \"vertices\": %d, \"edges\": %lld, "
+               "\"threads\": %d, \"algo\": \"%s\", \"root\": %d, \"seconds\": %.6g, \"teps\": %.6g, "
+               "\"levels\": %d, \"level_seconds\": [%s], \"peak_rss_mb\": %.1f, \"valid\": %s}",
+               first ? "" : ",\n", rec.gen.c_str(), rec.scale, rec.edgeFactor, rec.V, (long long)rec.edges,
+               rec.threads, rec.algo.c_str(), rec.root, rec.seconds, rec.teps, rec.levels, levels.c_str(),
+               rec.peakMB, rec.valid ? "true" : "false");
+    else
+        printf("%s,%d,%d,%d,%lld,%d,%s,%d,%.6g,%.6g,%d,%s,%.1f,%d\n", rec.gen.c_str(), rec.scale,
+               rec.edgeFactor, rec.V, (long long)rec.edges, rec.threads, rec.algo.c_str(), rec.root,
+               rec.seconds, rec.teps, rec.levels, levels.c_str(), rec.peakMB, rec.valid ? 1 : 0);
+    fflush(stdout);
+}
+
+bool parseArgs(int argc, char *argv[], BenchOptions &opt)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--compressed") == 0)
+        {
+            opt.compressed = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        const char *key = argv[i], *value = argv[++i];
+        if (strcmp(key, "--gen") == 0)
+            opt.gens = splitList(value);
+        else if (strcmp(key, "--scale") == 0)
+            opt.scales = splitInts(value);
+        else if (strcmp(key, "--edgefactor") == 0)
+            opt.edgeFactors = splitInts(value);
+        else if (strcmp(key, "--threads") == 0)
+            opt.threads = splitInts(value);
+        else if (strcmp(key, "--algo") == 0)
+            opt.algos = splitList(value);
+        else if (strcmp(key, "--roots") == 0)
+            opt.roots = atoi(value);
+        else if (strcmp(key, "--seed") == 0)
+            opt.seed = strtoull(value, NULL, 10);
+        else if (strcmp(key, "--format") == 0)
+            opt.json = strcmp(value, "json") == 0;
+        else
+            return false;
+    }
+
+    for (int s : opt.scales)
+        if (s < 1 || s > 30)
+            return false;
+    for (int t : opt.threads)
+        if (t < 1)
+            return false;
+    for (const string &a : opt.algos)
+        if (a != "bfs" && a != "dobfs" && a != "dfs" && a != "seqdfs" && a != "sssp")
+            return false;
+    return opt.roots >= 1;
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        cerr << "Usage: " << argv[0] << " [--gen rmat,grid2d,grid3d,regular,chain,tree] [--scale 14,16]"
+             << " [--edgefactor 16] [--threads 1,2,4] [--algo bfs,dobfs,dfs,seqdfs,sssp] [--roots 8] [--seed 1]"
+             << " [--format csv|json] [--compressed]" << endl;
+        return 1;
+    }
+
+    printHeader(opt);
+    bool first = true, allValid = true;
+    BFSResult bfs;
+    DFSResult dfs;
+    SSSPResult sssp;
+
+    for (const string &gen : opt.gens)
+        for (int scale : opt.scales)
+            for (int edgeFactor : opt.edgeFactors)
+            {
+                Graph g;
+                double t0 = omp_get_wtime();
+                if (!generate(gen, scale, edgeFactor, opt.seed, g))
+                {
+                    cerr << "Unknown generator " << gen << endl;
+                    return 1;
+                }
+                cerr << gen << " scale " << scale << " edgefactor " << edgeFactor << ": " << g.V
+                     << " vertices, " << g.numEdges() / 2 << " edges, " << g.memoryBytes() / 1048576.0
+                     << " MB, generated in " << omp_get_wtime() - t0 << " s" << endl;
+
+                vector<int> roots = pickRoots(g, opt.roots, opt.seed ^ ((uint64_t)scale << 32));
+                vector<vector<int>> refLevels(roots.size());
+                vector<int64_t> reached(roots.size(), 0), componentEdges(roots.size(), 0);
+                for (size_t i = 0; i < roots.size(); i++)
+                {
+                    referenceBFS(g, roots[i], refLevels[i]);
+                    for (int v = 0; v < g.V; v++)
+                        if (refLevels[i][v] >= 0)
+                        {
+                            reached[i]++;
+                            componentEdges[i] += g.degree(v);
+                        }
+                    componentEdges[i] /= 2;
+                }
+
+                CompressedGraph cg;
+                if (opt.compressed)
+                {
+                    t0 = omp_get_wtime();
+                    cg = CompressedGraph::fromGraph(g);
+                    cerr << "  compressed: " << cg.memoryBytes() / 1048576.0 << " MB ("
+                         << (double)g.memoryBytes() / cg.memoryBytes() << "x smaller) in "
+                         << omp_get_wtime() - t0 << " s" << endl;
+                }
+
+                // Weighted copy and Dijkstra references, only if SSSP is benchmarked
+                WeightedGraph wg;
+                vector<SSSPResult> refPaths;
+                if (find(opt.algos.begin(), opt.algos.end(), "sssp") != opt.algos.end())
+                {
+                    uint64_t seed = opt.seed;
+                    wg = WeightedGraph::fromGraph(g, [seed](int u, int v) { return edgeWeight(u, v, seed); });
+                    refPaths.resize(roots.size());
+                    t0 = omp_get_wtime();
+                    for (size_t i = 0; i < roots.size(); i++)
+                        dijkstraSSSP(wg, roots[i], refPaths[i]);
+                    cerr << "  sequential Dijkstra: " << (omp_get_wtime() - t0) / max<size_t>(1, roots.size())
+                         << " s per root, delta " << wg.suggestedDelta() << endl;
+                }
+
+                for (int t : opt.threads)
+                {
+                    omp_set_num_threads(t);
+                    for (const string &algo : opt.algos)
+                    {
+                        double inverseTEPS = 0;
+                        for (size_t i = 0; i < roots.size(); i++)
+                        {
+                            RunRecord rec;
+                            rec.gen = gen;
+                            rec.algo = algo;
+                            rec.scale = scale;
+                            rec.edgeFactor = edgeFactor;
+                            rec.V = g.V;
+                            rec.edges = g.numEdges() / 2;
+                            rec.threads = t;
+                            rec.root = roots[i];
+
+                            if (algo == "sssp")
+                            {
+                                t0 = omp_get_wtime();
+                                deltaStepping(wg, roots[i], sssp);
+                                rec.seconds = omp_get_wtime() - t0;
+                                rec.valid = validateSSSP(wg, roots[i], sssp, refPaths[i]);
+                                rec.levels = (int)sssp.buckets;
+                            }
+                            else if (algo == "dfs" || algo == "seqdfs")
+                            {
+                                DFSVisitor none;
+                                t0 = omp_get_wtime();
+                                if (algo == "seqdfs" && opt.compressed)
+                                    sequentialDFS(cg, roots[i], dfs, none);
+                                else if (algo == "seqdfs")
+                                    sequentialDFS(g, roots[i], dfs, none);
+                                else if (opt.compressed)
+                                    parallelDFS(cg, roots[i], dfs);
+                                else
+                                    parallelDFS(g, roots[i], dfs);
+                                rec.seconds = omp_get_wtime() - t0;
+                                rec.valid = validateDFS(g, roots[i], dfs, refLevels[i], reached[i]);
+                                rec.levels = 0;
+                                for (int v : dfs.order)
+                                    rec.levels = max(rec.levels, dfs.depth[v] + 1);
+                            }
+                            else
+                            {
+                                BFSOptions bo;
+                                bo.directionOptimizing = algo == "dobfs";
+                                t0 = omp_get_wtime();
+                                if (opt.compressed)
+                                    levelSyncBFS(cg, roots[i], bfs, bo);
+                                else
+                                    levelSyncBFS(g, roots[i], bfs, bo);
+                                rec.seconds = omp_get_wtime() - t0;
+                                rec.valid = validateBFS(g, roots[i], bfs, refLevels[i]);
+                                rec.levels = (int)bfs.levelSeconds.size();
+                                rec.levelSeconds = bfs.levelSeconds;
+                            }
+
+                            rec.seconds = max(rec.seconds, 1e-9);
+                            rec.teps = componentEdges[i] / rec.seconds;
+                            rec.peakMB = peakMemoryMB();
+                            inverseTEPS += 1 / max(rec.teps, 1e-9);
+                            allValid = allValid && rec.valid;
+                            printRecord(opt, rec, first);
+                            first = false;
+                        }
+
+                        // Graph500 reports the harmonic mean, the right average for rates
+                        cerr << "  " << algo << ", " << t << " threads: harmonic mean "
+                             << roots.size() / inverseTEPS / 1e6 << " MTEPS over " << roots.size()
+                             << " roots" << endl;
+                    }
+                }
+            }
+
+    if (opt.json)
+        printf("\n]\n");
+    if (!allValid)
+        cerr << "VALIDATION FAILED for at least one run" << endl;
+    return allValid ? 0 : 2;
+}
@@ -0,0 +1,277 @@
+/*
+ * Merge sort engine for arrays of any type with operator< (04_Merge_Sort.cpp sorts ints).
+ *
+ * sequentialMergeSort(a) / parallelMergeSort(a, cutoff)
+ *   Sort a vector; one scratch buffer of the same size is allocated once per call.
+ * sequentialMergeSort(a, n, scratch) / parallelMergeSort(a, n, scratch, cutoff)
+ *   Same on raw arrays with a caller-owned scratch of n elements: no allocation at all,
+ *   so repeated sorts can reuse one buffer.
+ *
+ * Both are stable. Instead of merging into a temporary and copying back, every level
+ * merges from one buffer into the other (ping-pong): a range that must end up in dst
+ * has its halves sorted into src, and vice versa, so each level moves the data exactly
+ * once. Ranges of at most INSERTION_CUTOFF elements are insertion-sorted straight into
+ * whichever buffer they must end up in.
+ *
+ * For int keys the leaves and merges use the SIMD kernels of sortnet.h instead: leaves of
+ * up to SORTNET_BLOCK elements are sorted by in-register sorting networks (sortBlock)
+ * and every merge runs the bitonic merge kernel (mergeSorted), with the instruction set
+ * picked at run time. mergeStep/sortLeaf/leafSize below are the overloads that select
+ * them; other types keep the scalar code.
+ *
+ * The parallel sort opens one parallel region and recurses with OpenMP tasks: the left
+ * half becomes a task, the right half runs on the current thread, and ranges of at most
+ * cutoff elements are sorted sequentially, so no task is ever smaller than that.
+ * Merges of more than cutoff elements are split with merge path (below) into tasks of
+ * about cutoff elements, so even the last merge of the whole array uses every thread.
+ *
+ * parallelMerge(a, na, b, nb, out) / parallelMerge(a, b)
+ *   Standalone stable merge of two sorted arrays with all threads. Merge path: output
+ *   position k of the merge takes coRank(k) elements from a and k - coRank(k) from b,
+ *   found by a binary search along the k-th cross diagonal. Cutting the output into p
+ *   equal segments therefore cuts both inputs into p independent merges of equal size.
+ * parallelMergeRuns(data, runStart)
+ *   Merges consecutive sorted runs of data (run r starts at runStart[r]) pairwise with
+ *   parallelMerge, ping-ponging between data and one scratch buffer.
+ */
+
+#ifndef MERGESORT_H
+#define MERGESORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "sortnet.h"
+
+const int64_t INSERTION_CUTOFF = 32;
+const int64_t DEFAULT_TASK_CUTOFF = 1 << 14;
+
+// Merges the sorted runs [a, aEnd) and [b, bEnd) into out; equal keys come from a first
+template <class T>
+inline void mergeRuns(const T *a, const T *aEnd, const T *b, const T *bEnd, T *out)
+{
+    while (a != aEnd && b != bEnd)
+        *out++ = *b < *a ? *b++ : *a++;
+    out = std::copy(a, aEnd, out);
+    std::copy(b, bEnd, out);
+}
+
+// The merge used by the sorts: scalar in general, the SIMD kernel for int
+template <class T>
+inline void mergeStep(const T *a, const T *aEnd, const T *b, const T *bEnd, T *out)
+{
+    mergeRuns(a, aEnd, b, bEnd, out);
+}
+
+inline void mergeStep(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+{
+    mergeSorted(a, aEnd - a, b, bEnd - b, out);
+}
+
+// Number of elements of a among the first k of the stable merge of a and b: the
+// smallest i with b[k - i - 1] < a[i], searched on [max(0, k - nb), min(k, na)]
+template <class T>
+inline int64_t coRank(int64_t k, const T *a, int64_t na, const T *b, int64_t nb)
+{
+    int64_t lo = std::max<int64_t>(0, k - nb), hi = std::min(k, na);
+    while (lo < hi)
+    {
+        int64_t i = lo + (hi - lo) / 2;
+        if (b[k - i - 1] < a[i])
+            hi = i;
+        else
+            lo = i + 1;
+    }
+    return lo;
+}
+
+// Writes out[k0 .. k1) of the merge of a and b; segments are independent of each other
+template <class T>
+inline void mergeSegment(const T *a, int64_t na, const T *b, int64_t nb, T *out, int64_t k0, int64_t k1)
+{
+    int64_t i0 = coRank(k0, a, na, b, nb), i1 = coRank(k1, a, na, b, nb);
+    mergeStep(a + i0, a + i1, b + (k0 - i0), b + (k1 - i1), out + k0);
+}
+
+// Merge of a and b as tasks of about grain elements (at most 4 per thread); call inside
+// a parallel region
+template <class T>
+void mergeTasks(const T *a, int64_t na, const T *b, int64_t nb, T *out, int64_t grain)
+{
+    int64_t n = na + nb;
+    int64_t pieces = std::min<int64_t>((n + grain - 1) / grain, 4 * omp_get_num_threads());
+    if (pieces <= 1)
+    {
+        mergeStep(a, a + na, b, b + nb, out);
+        return;
+    }
+    for (int64_t p = 1; p < pieces; p++)
+    {
+#pragma omp task default(none) firstprivate(a, na, b, nb, out, n, p, pieces)
+        mergeSegment(a, na, b, nb, out, n * p / pieces, n * (p + 1) / pieces);
+    }
+    mergeSegment(a, na, b, nb, out, 0, n / pieces);
+#pragma omp taskwait
+}
+
+// Insertion sort of src[0 .. n) written to dst; src and dst may be the same array
+template <class T>
+inline void insertionSortInto(const T *src, T *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; i++)
+    {
+        T x = src[i];
+        int64_t j = i;
+        for (; j > 0 && x < dst[j - 1]; j--)
+            dst[j] = dst[j - 1];
+        dst[j] = x;
+    }
+}
+
+// Largest range sorted as one leaf, and the leaf sort itself (src and dst may be equal)
+template <class T>
+inline int64_t leafSize(const T *)
+{
+    return INSERTION_CUTOFF;
+}
+
+inline int64_t leafSize(const int *)
+{
+    return sortNetLevel() == SIMD_SCALAR ? INSERTION_CUTOFF : SORTNET_BLOCK;
+}
+
+template <class T>
+inline void sortLeaf(const T *src, T *dst, int64_t n)
+{
+    insertionSortInto(src, dst, n);
+}
+
+inline void sortLeaf(const int *src, int *dst, int64_t n)
+{
+    sortBlock(src, dst, (int)n);
+}
+
+// Sorts the n elements of a; the result lands in b if toB, else in a. Both arrays are
+// overwritten.
+template <class T>
+void mergeSortPingPong(T *a, T *b, int64_t n, bool toB)
+{
+    if (n <= leafSize(a))
+    {
+        sortLeaf(a, toB ? b : a, n);
+        return;
+    }
+    int64_t half = n / 2;
+    mergeSortPingPong(a, b, half, !toB);
+    mergeSortPingPong(a + half, b + half, n - half, !toB);
+    const T *src = toB ? a : b;
+    mergeStep(src, src + half, src + half, src + n, toB ? b : a);
+}
+
+// Task-parallel version of mergeSortPingPong; call inside a parallel region
+template <class T>
+void mergeSortTasks(T *a, T *b, int64_t n, bool toB, int64_t cutoff)
+{
+    if (n <= cutoff)
+    {
+        mergeSortPingPong(a, b, n, toB);
+        return;
+    }
+    int64_t half = n / 2;
+#pragma omp task default(none) firstprivate(a, b, half, toB, cutoff)
+    mergeSortTasks(a, b, half, !toB, cutoff);
+    mergeSortTasks(a + half, b + half, n - half, !toB, cutoff);
+#pragma omp taskwait
+
+    const T *src = toB ? a : b;
+    mergeTasks(src, half, src + half, n - half, toB ? b : a, cutoff);
+}
+
+template <class T>
+void sequentialMergeSort(T *a, int64_t n, T *scratch)
+{
+    mergeSortPingPong(a, scratch, n, false);
+}
+
+template <class T>
+void parallelMergeSort(T *a, int64_t n, T *scratch, int64_t cutoff = DEFAULT_TASK_CUTOFF)
+{
+    cutoff = std::max(cutoff, leafSize(a));
+    if (n <= cutoff)
+    {
+        mergeSortPingPong(a, scratch, n, false);
+        return;
+    }
+#pragma omp parallel
+#pragma omp single nowait
+    mergeSortTasks(a, scratch, n, false, cutoff);
+}
+
+template <class T>
+void sequentialMergeSort(std::vector<T> &a)
+{
+    std::vector<T> scratch(a.size());
+    sequentialMergeSort(a.data(), (int64_t)a.size(), scratch.data());
+}
+
+template <class T>
+void parallelMergeSort(std::vector<T> &a, int64_t cutoff = DEFAULT_TASK_CUTOFF)
+{
+    std::vector<T> scratch(a.size());
+    parallelMergeSort(a.data(), (int64_t)a.size(), scratch.data(), cutoff);
+}
+
+// Stable merge of the sorted arrays a and b into out (na + nb elements), one segment of
+// the merge path per thread
+template <class T>
+void parallelMerge(const T *a, int64_t na, const T *b, int64_t nb, T *out)
+{
+    int64_t n = na + nb;
+#pragma omp parallel if (n > DEFAULT_TASK_CUTOFF)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        mergeSegment(a, na, b, nb, out, n * t / nt, n * (t + 1) / nt);
+    }
+}
+
+template <class T>
+std::vector<T> parallelMerge(const std::vector<T> &a, const std::vector<T> &b)
+{
+    std::vector<T> out(a.size() + b.size());
+    parallelMerge(a.data(), (int64_t)a.size(), b.data(), (int64_t)b.size(), out.data());
+    return out;
+}
+
+// Merges the sorted runs data[runStart[r] .. runStart[r + 1]) (the last one ends at
+// data.size()) into one sorted array; log2(runs) rounds of pairwise parallel merges
+template <class T>
+void parallelMergeRuns(std::vector<T> &data, std::vector<int64_t> runStart)
+{
+    const int64_t n = data.size();
+    runStart.push_back(n);
+    std::vector<T> scratch(n);
+    T *src = data.data(), *dst = scratch.data();
+
+    while (runStart.size() > 2)
+    {
+        std::vector<int64_t> merged;
+        for (size_t r = 0; r + 1 < runStart.size(); r += 2)
+        {
+            int64_t lo = runStart[r], mid = runStart[r + 1];
+            int64_t hi = r + 2 < runStart.size() ? runStart[r + 2] : mid;
+            if (hi > mid)
+                parallelMerge(src + lo, mid - lo, src + mid, hi - mid, dst + lo);
+            else
+                std::copy(src + lo, src + mid, dst + lo); // odd run out: carried to the next round
+            merged.push_back(lo);
+        }
+        merged.push_back(n);
+        runStart.swap(merged);
+        std::swap(src, dst);
+    }
+    if (src != data.data())
+        data.swap(scratch);
+}
+
+#endif
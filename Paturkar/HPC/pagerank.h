@@ -0,0 +1,317 @@
+/*
+ * PageRank and degree statistics over the CSR Graph from graph.h.
+ *
+ * pageRank(g, opt) / pageRank(g, result, opt)
+ *   Pull-based power iteration: every vertex sums contrib[u] = score[u] / degree(u) over
+ *   its neighbors (the Graph stores both directions of every edge, so the neighbor list
+ *   is also the in-list), with the inverse degrees computed once up front. One parallel
+ *   sweep per iteration writes the new scores and the next contributions (double
+ *   buffered) and reduces the mass of dangling (isolated) vertices and the L1 change;
+ *   the iteration stops once the change drops below opt.tolerance.
+ *   The same pass that computes the inverse degrees also fills result.degrees, so the
+ *   degree distribution costs no extra sweep over the graph.
+ *
+ *   With opt.segmentVertices > 0 the sweep is cache blocked (CSR segmenting): the
+ *   sources are cut into segments of that many vertices, whose contributions fit in
+ *   the cache, and every segment is swept on its own from a SegmentedGraph that lists,
+ *   per segment, the destinations with at least one source in it. The random reads of
+ *   contrib[] then stay inside one segment; the price is one partial sum per
+ *   destination and segment. Pays off once contrib[] (8 bytes per vertex) is much
+ *   larger than the last-level cache.
+ */
+
+#ifndef PAGERANK_H
+#define PAGERANK_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+
+struct PageRankOptions
+{
+    double damping = 0.85;
+    double tolerance = 1e-6; // on the L1 change of the score vector
+    int maxIterations = 100;
+    int segmentVertices = 0; // > 0: cache-blocked sweep over source segments this large
+};
+
+struct DegreeStats
+{
+    int minDegree = 0, maxDegree = 0;
+    double mean = 0, stddev = 0;
+    int64_t isolated = 0;           // vertices without edges
+    std::vector<int64_t> histogram; // [0]: degree 0, [k]: degree in [2^(k-1), 2^k)
+};
+
+struct PageRankResult
+{
+    std::vector<double> score; // sums to 1
+    int iterations = 0;
+    double change = 0;         // L1 change of the last iteration
+    bool converged = false;
+    double setupSeconds = 0;   // inverse degrees, degree statistics and segmenting
+    DegreeStats degrees;
+};
+
+// The sources of a graph cut into segments, one small CSR per segment (see pageRank)
+struct SegmentedGraph
+{
+    int segmentVertices = 0, numSegments = 0;
+    std::vector<int64_t> dstStart; // dst[dstStart[s] .. dstStart[s + 1]) belong to segment s
+    std::vector<int> dst;          // per segment in increasing order
+    std::vector<int64_t> srcStart; // src[srcStart[k] .. srcStart[k + 1]) are dst[k]'s sources
+    std::vector<int> src;
+
+    // Two passes over fixed vertex ranges, one per thread: count per (thread, segment),
+    // then write at offsets from a segment-major prefix sum, which keeps every
+    // segment's destinations in increasing order
+    static SegmentedGraph build(const Graph &g, int segmentVertices)
+    {
+        SegmentedGraph sg;
+        sg.segmentVertices = segmentVertices;
+        sg.numSegments = (g.V + segmentVertices - 1) / segmentVertices;
+        const int S = sg.numSegments;
+        int maxThreads = omp_get_max_threads();
+        std::vector<int64_t> dstAt((size_t)maxThreads * S, 0), srcAt((size_t)maxThreads * S, 0);
+        sg.dstStart.assign(S + 1, 0);
+
+#pragma omp parallel num_threads(maxThreads)
+        {
+            int t = omp_get_thread_num(), nt = omp_get_num_threads();
+            int lo = (int)((int64_t)g.V * t / nt), hi = (int)((int64_t)g.V * (t + 1) / nt);
+            int64_t *myDst = &dstAt[(size_t)t * S], *mySrc = &srcAt[(size_t)t * S];
+            std::vector<int> count(S, 0), touched;
+
+            // Neighbors of v per segment; touched lists the segments with count > 0
+            auto countSegments = [&](int v)
+            {
+                touched.clear();
+                for (const int *p = g.begin(v); p != g.end(v); ++p)
+                    if (count[*p / segmentVertices]++ == 0)
+                        touched.push_back(*p / segmentVertices);
+            };
+
+            for (int v = lo; v < hi; v++)
+            {
+                countSegments(v);
+                for (int s : touched)
+                {
+                    myDst[s]++;
+                    mySrc[s] += count[s];
+                    count[s] = 0;
+                }
+            }
+
+#pragma omp barrier
+#pragma omp single
+            {
+                int64_t dsts = 0, srcs = 0;
+                for (int s = 0; s < S; s++)
+                {
+                    sg.dstStart[s] = dsts;
+                    for (int k = 0; k < nt; k++)
+                    {
+                        std::swap(dsts, dstAt[(size_t)k * S + s]);
+                        dsts += dstAt[(size_t)k * S + s];
+                        std::swap(srcs, srcAt[(size_t)k * S + s]);
+                        srcs += srcAt[(size_t)k * S + s];
+                    }
+                }
+                sg.dstStart[S] = dsts;
+                sg.dst.resize(dsts);
+                sg.srcStart.resize(dsts + 1);
+                sg.srcStart[dsts] = srcs;
+                sg.src.resize(srcs);
+            }
+
+            for (int v = lo; v < hi; v++)
+            {
+                countSegments(v);
+                for (int s : touched)
+                {
+                    sg.dst[myDst[s]] = v;
+                    sg.srcStart[myDst[s]++] = mySrc[s];
+                    mySrc[s] += count[s];
+                    count[s] = 0;
+                }
+                for (const int *p = g.begin(v); p != g.end(v); ++p)
+                {
+                    int s = *p / segmentVertices;
+                    sg.src[sg.srcStart[myDst[s] - 1] + count[s]++] = *p;
+                }
+                for (int s : touched)
+                    count[s] = 0;
+            }
+        }
+        return sg;
+    }
+
+    size_t memoryBytes() const
+    {
+        return (dstStart.size() + srcStart.size()) * sizeof(int64_t) + (dst.size() + src.size()) * sizeof(int);
+    }
+};
+
+// Fills invDegree (0 for isolated vertices) and the degree statistics in one sweep
+inline void inverseDegrees(const Graph &g, std::vector<double> &invDegree, DegreeStats &d)
+{
+    invDegree.resize(g.V);
+    int minDegree = g.V > 0 ? g.degree(0) : 0, maxDegree = 0;
+    double sum = 0, sumSquares = 0;
+    int64_t isolated = 0;
+    std::vector<int64_t> histogram(33, 0);
+
+#pragma omp parallel reduction(min : minDegree) reduction(max : maxDegree) reduction(+ : sum, sumSquares, isolated)
+    {
+        std::vector<int64_t> local(33, 0);
+
+#pragma omp for schedule(static)
+        for (int v = 0; v < g.V; v++)
+        {
+            int deg = g.degree(v);
+            invDegree[v] = deg > 0 ? 1.0 / deg : 0.0;
+            minDegree = std::min(minDegree, deg);
+            maxDegree = std::max(maxDegree, deg);
+            sum += deg;
+            sumSquares += (double)deg * deg;
+            isolated += deg == 0;
+            local[deg == 0 ? 0 : 32 - __builtin_clz(deg)]++;
+        }
+
+        for (int k = 0; k < 33; k++)
+            if (local[k])
+                __atomic_fetch_add(&histogram[k], local[k], __ATOMIC_RELAXED);
+    }
+
+    int last = 32;
+    while (last > 0 && histogram[last] == 0)
+        last--;
+    histogram.resize(last + 1);
+
+    d.minDegree = minDegree;
+    d.maxDegree = maxDegree;
+    d.mean = g.V > 0 ? sum / g.V : 0;
+    d.stddev = g.V > 0 ? std::sqrt(std::max(0.0, sumSquares / g.V - d.mean * d.mean)) : 0;
+    d.isolated = isolated;
+    d.histogram.swap(histogram);
+}
+
+inline DegreeStats degreeStats(const Graph &g)
+{
+    std::vector<double> invDegree;
+    DegreeStats d;
+    inverseDegrees(g, invDegree, d);
+    return d;
+}
+
+inline void pageRank(const Graph &g, PageRankResult &r, const PageRankOptions &opt = PageRankOptions())
+{
+    const int V = g.V;
+    const double d = opt.damping;
+    double start = omp_get_wtime();
+    std::vector<double> invDegree;
+    inverseDegrees(g, invDegree, r.degrees);
+
+    r.score.assign(V, V > 0 ? 1.0 / V : 0.0);
+    r.iterations = 0;
+    r.change = 0;
+    r.converged = false;
+    if (V == 0)
+        return;
+
+    std::vector<double> next(V), contrib(V), nextContrib(V), sums;
+    double dangling = 0;
+#pragma omp parallel for reduction(+ : dangling)
+    for (int v = 0; v < V; v++)
+    {
+        contrib[v] = r.score[v] * invDegree[v];
+        dangling += invDegree[v] == 0 ? r.score[v] : 0;
+    }
+
+    SegmentedGraph sg;
+    if (opt.segmentVertices > 0)
+    {
+        sg = SegmentedGraph::build(g, opt.segmentVertices);
+        sums.resize(V);
+    }
+    r.setupSeconds = omp_get_wtime() - start;
+
+    while (r.iterations < opt.maxIterations)
+    {
+        // Teleport plus the dangling mass, spread evenly over all vertices
+        double base = (1 - d) / V + d * dangling / V;
+        double change = 0, nextDangling = 0;
+
+        if (opt.segmentVertices <= 0)
+        {
+#pragma omp parallel for schedule(dynamic, 1024) reduction(+ : change, nextDangling)
+            for (int v = 0; v < V; v++)
+            {
+                double sum = 0;
+                for (const int *p = g.begin(v); p != g.end(v); ++p)
+                    sum += contrib[*p];
+                double s = base + d * sum;
+                change += std::fabs(s - r.score[v]);
+                next[v] = s;
+                nextContrib[v] = s * invDegree[v];
+                nextDangling += invDegree[v] == 0 ? s : 0;
+            }
+        }
+        else
+        {
+#pragma omp parallel
+            {
+#pragma omp for schedule(static)
+                for (int v = 0; v < V; v++)
+                    sums[v] = 0;
+
+                // Segment by segment: every destination appears at most once per segment,
+                // so the partial sums need no atomics
+                for (int s = 0; s < sg.numSegments; s++)
+                {
+#pragma omp for schedule(dynamic, 1024)
+                    for (int64_t k = sg.dstStart[s]; k < sg.dstStart[s + 1]; k++)
+                    {
+                        double sum = 0;
+                        for (int64_t e = sg.srcStart[k]; e < sg.srcStart[k + 1]; e++)
+                            sum += contrib[sg.src[e]];
+                        sums[sg.dst[k]] += sum;
+                    }
+                }
+
+#pragma omp for schedule(static) reduction(+ : change, nextDangling)
+                for (int v = 0; v < V; v++)
+                {
+                    double s = base + d * sums[v];
+                    change += std::fabs(s - r.score[v]);
+                    next[v] = s;
+                    nextContrib[v] = s * invDegree[v];
+                    nextDangling += invDegree[v] == 0 ? s : 0;
+                }
+            }
+        }
+
+        r.score.swap(next);
+        contrib.swap(nextContrib);
+        dangling = nextDangling;
+        r.change = change;
+        r.iterations++;
+        if (change < opt.tolerance)
+        {
+            r.converged = true;
+            break;
+        }
+    }
+}
+
+inline PageRankResult pageRank(const Graph &g, const PageRankOptions &opt = PageRankOptions())
+{
+    PageRankResult r;
+    pageRank(g, r, opt);
+    return r;
+}
+
+#endif
@@ -0,0 +1,454 @@
+/*
+ * BFS over a graph partitioned across several processes that only talk through a
+ * Transport (transport.h). Every process keeps its share of the edges and of the BFS
+ * state, so the graph can be larger than the memory of one process.
+ *
+ * Partition
+ *   Vertices are split into P contiguous blocks; rank r owns block r (its level and
+ *   parent entries). The ranks form an R x C grid, rank r = i * C + j, and rank (i, j)
+ *   stores the directed entries u -> v with u owned by a rank of grid column j and v
+ *   owned by a rank of grid row i:
+ *     1D  the 1 x P grid: every rank stores the full neighbor lists of its own vertices
+ *     2D  R ~ C ~ sqrt(P): a rank only exchanges with the R + C - 2 ranks of its grid
+ *         row and column, and the volume per rank shrinks with sqrt(P)
+ *   buildLocalGraph() takes this rank's share of the edge list (e.g. its slice of an
+ *   R-MAT stream) and routes every entry to the rank that stores it in one exchange.
+ *
+ * partitionedBFS(t, part, g, root, r)
+ *   Level-synchronous; every level is three collectives at most, each with one batched
+ *   buffer per destination:
+ *     stats   an allgather of 24 bytes per rank (frontier size, frontier edges, bytes of
+ *             a bottom-up broadcast): it detects the end of the search and picks the
+ *             direction, and is a global synchronization point even when the level
+ *             moves nothing else (counted in r.bytes, not in r.levelBytes)
+ *     expand  every rank sends its frontier to the ranks of its grid column (nothing
+ *             to send in 1D)
+ *     fold    the stored entries of the frontier are scanned and every newly reached
+ *             target is sent as a (vertex, parent) pair to its owner, in the same grid
+ *             row; a per-rank bitmap makes sure each target is sent at most once
+ *   A frontier travels either as a list of ids or as a bitmap over the owner's block,
+ *   whichever is smaller, so dense frontiers cost one bit per vertex.
+ *   In 1D, levels where it moves fewer bytes go bottom-up: every rank broadcasts its
+ *   frontier (list or bitmap) and its unvisited vertices look for a parent in it, which
+ *   replaces the 8-byte pairs of the fold by at most V / 8 bytes per rank. As in
+ *   directionOptimizingBFS (bfs.h), this is only done once the frontier edges exceed
+ *   unexplored edges / alpha, so bottom-up scans stay cheap.
+ */
+
+#ifndef PARTITIONED_BFS_H
+#define PARTITIONED_BFS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "bfs.h"
+#include "transport.h"
+
+struct Partition
+{
+    int P = 1, R = 1, C = 1; // R x C process grid
+    int64_t V = 0;
+    int64_t chunk = 1;       // vertices per block, block r is [lo(r), hi(r))
+
+    Partition() {}
+
+    Partition(int64_t V, int P, bool twoD) : P(P), V(V)
+    {
+        if (twoD)
+            for (int rows = 1; rows * rows <= P; rows++)
+                if (P % rows == 0)
+                    R = rows;
+        C = P / R;
+        chunk = std::max<int64_t>(1, (V + P - 1) / P);
+    }
+
+    int owner(int v) const { return (int)(v / chunk); }
+    int64_t lo(int r) const { return std::min(V, r * chunk); }
+    int64_t hi(int r) const { return std::min(V, (r + 1) * chunk); }
+
+    // Rank that stores the entry u -> v
+    int storeRank(int u, int v) const { return owner(v) / C * C + owner(u) % C; }
+
+    // Position of u among the sources of its grid column, of v among the targets of its row
+    int64_t sourceIndex(int u) const { return owner(u) / C * chunk + (u - owner(u) * chunk); }
+    int64_t targetIndex(int v) const { return owner(v) % C * chunk + (v - owner(v) * chunk); }
+};
+
+// The entries stored by one rank, CSR over its sources
+struct LocalGraph
+{
+    std::vector<int64_t> offsets; // by Partition::sourceIndex(u), R * chunk + 1 entries
+    std::vector<int> targets;     // global ids, sorted and without duplicates per source
+
+    int64_t numEntries() const { return targets.size(); }
+
+    size_t memoryBytes() const
+    {
+        return offsets.size() * sizeof(int64_t) + targets.size() * sizeof(int);
+    }
+};
+
+struct PartitionedBFSResult
+{
+    std::vector<int> level;          // of the vertices this rank owns (v - lo), -1 if unreached
+    std::vector<int> parent;         // global id of the BFS parent, -1 for root and unreached
+    std::vector<char> direction;     // per level: 'T' top-down or 'B' bottom-up
+    std::vector<int64_t> levelBytes; // per level: expand/fold bytes sent by all ranks together
+    int64_t reached = 0;             // vertices reached, all ranks
+    int64_t edges = 0;               // undirected edges inside the reached component
+    int64_t bytes = 0;               // bytes sent by all ranks during the search
+};
+
+struct PartitionedBFSOptions
+{
+    bool bottomUp = true; // allow bottom-up levels (1D only)
+    double alpha = 15;    // bottom-up needs frontier edges > unexplored edges / alpha
+};
+
+inline void appendInts(std::vector<uint8_t> &buf, const int *values, size_t n)
+{
+    size_t at = buf.size();
+    buf.resize(at + n * sizeof(int));
+    memcpy(buf.data() + at, values, n * sizeof(int));
+}
+
+// Size of encodeFrontier()'s output for count vertices of a block
+inline int64_t frontierBytes(int64_t count, int64_t blockSize)
+{
+    return 1 + std::min<int64_t>(count * 4, (blockSize + 63) / 64 * 8);
+}
+
+// A frontier of block-local ids, as a list (tag 0) or a bitmap over the block (tag 1)
+inline void encodeFrontier(const std::vector<int> &ids, int64_t blockSize, std::vector<uint8_t> &out)
+{
+    int64_t words = (blockSize + 63) / 64;
+    if ((int64_t)ids.size() * 4 <= words * 8)
+    {
+        out.assign(1, 0);
+        appendInts(out, ids.data(), ids.size());
+        return;
+    }
+    std::vector<uint64_t> bits(words, 0);
+    for (int v : ids)
+        bits[v >> 6] |= 1ULL << (v & 63);
+    out.assign(1 + words * 8, 1);
+    memcpy(out.data() + 1, bits.data(), words * 8);
+}
+
+// Calls f(id) for every block-local id of an encoded frontier
+template <class F>
+void decodeFrontier(const std::vector<uint8_t> &msg, F f)
+{
+    if (msg.empty())
+        return;
+    const uint8_t *p = msg.data() + 1;
+    if (msg[0] == 0)
+    {
+        for (size_t k = 0; k < (msg.size() - 1) / 4; k++)
+        {
+            int v;
+            memcpy(&v, p + 4 * k, 4);
+            f(v);
+        }
+        return;
+    }
+    for (size_t w = 0; w < (msg.size() - 1) / 8; w++)
+    {
+        uint64_t word;
+        memcpy(&word, p + 8 * w, 8);
+        while (word)
+        {
+            f((int)(w * 64 + __builtin_ctzll(word)));
+            word &= word - 1;
+        }
+    }
+}
+
+// Routes both directions of every edge of this rank's share to the rank storing them,
+// then builds the local CSR. Self-loops and duplicate entries are dropped.
+inline LocalGraph buildLocalGraph(Transport &t, const Partition &part,
+                                  const std::vector<std::pair<int, int>> &edges)
+{
+    MessageBuffers send(part.P), recv;
+    std::vector<int64_t> count(part.P, 0);
+    for (const std::pair<int, int> &e : edges)
+        if (e.first != e.second)
+        {
+            count[part.storeRank(e.first, e.second)]++;
+            count[part.storeRank(e.second, e.first)]++;
+        }
+    for (int d = 0; d < part.P; d++)
+        send[d].reserve(count[d] * 2 * sizeof(int));
+    for (const std::pair<int, int> &e : edges)
+        if (e.first != e.second)
+        {
+            int fwd[2] = {e.first, e.second}, back[2] = {e.second, e.first};
+            appendInts(send[part.storeRank(e.first, e.second)], fwd, 2);
+            appendInts(send[part.storeRank(e.second, e.first)], back, 2);
+        }
+    t.exchange(send, recv);
+    send.clear();
+
+    LocalGraph g;
+    int64_t sources = part.R * part.chunk;
+    std::vector<int64_t> start(sources + 1, 0);
+    for (const std::vector<uint8_t> &msg : recv)
+        for (size_t k = 0; k < msg.size(); k += 8)
+        {
+            int u;
+            memcpy(&u, msg.data() + k, 4);
+            start[part.sourceIndex(u) + 1]++;
+        }
+    for (int64_t s = 0; s < sources; s++)
+        start[s + 1] += start[s];
+
+    std::vector<int> all(start[sources]);
+    std::vector<int64_t> cursor(start.begin(), start.end() - 1);
+    for (std::vector<uint8_t> &msg : recv)
+    {
+        for (size_t k = 0; k < msg.size(); k += 8)
+        {
+            int uv[2];
+            memcpy(uv, msg.data() + k, 8);
+            all[cursor[part.sourceIndex(uv[0])]++] = uv[1];
+        }
+        std::vector<uint8_t>().swap(msg);
+    }
+
+    // Sort and deduplicate every list in place, then compact
+    g.offsets.assign(sources + 1, 0);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int64_t s = 0; s < sources; s++)
+    {
+        std::sort(all.begin() + start[s], all.begin() + start[s + 1]);
+        g.offsets[s + 1] = std::unique(all.begin() + start[s], all.begin() + start[s + 1]) - (all.begin() + start[s]);
+    }
+    for (int64_t s = 0; s < sources; s++)
+        g.offsets[s + 1] += g.offsets[s];
+    g.targets.resize(g.offsets[sources]);
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int64_t s = 0; s < sources; s++)
+        std::copy(all.begin() + start[s], all.begin() + start[s] + (g.offsets[s + 1] - g.offsets[s]),
+                  g.targets.begin() + g.offsets[s]);
+    return g;
+}
+
+// Every rank calls this with the same root; r receives this rank's part of the result
+inline void partitionedBFS(Transport &t, const Partition &part, const LocalGraph &g, int root,
+                           PartitionedBFSResult &r,
+                           const PartitionedBFSOptions &opt = PartitionedBFSOptions())
+{
+    const int P = part.P, me = t.rank(), column = me % part.C;
+    const int64_t lo = part.lo(me), n = part.hi(me) - lo;
+    const bool oneD = part.R == 1;
+    int64_t startBytes = t.bytesSent;
+
+    r.level.assign(n, -1);
+    r.parent.assign(n, -1);
+    r.direction.clear();
+    r.levelBytes.clear();
+
+    std::vector<int> frontier, next;
+    if (part.owner(root) == me)
+    {
+        r.level[root - lo] = 0;
+        frontier.push_back(root - lo);
+    }
+
+    AtomicBitmap claimed((int)(part.C * part.chunk)); // targets of my grid row already sent
+    std::vector<uint64_t> inFrontier;          // global frontier bitmap, bottom-up only
+    std::vector<int> sources;
+    MessageBuffers send(P), recv;
+    std::vector<uint8_t> msg;
+    int64_t unexplored = t.allreduceSum(g.numEntries());
+    int64_t scanned = 0;
+
+    for (int depth = 0;; depth++)
+    {
+        // Stats collective: frontier size, frontier edges (1D: the owned lists are
+        // complete) and the bytes a bottom-up broadcast of this rank's frontier would take.
+        // It cannot ride on the fold exchange of the previous level, since the frontier
+        // is only known after that exchange has been received.
+        int64_t myEdges = 0;
+        if (oneD)
+            for (int v : frontier)
+                myEdges += g.offsets[v + 1] - g.offsets[v];
+        std::vector<int64_t> stats = t.allgather({(int64_t)frontier.size(), myEdges,
+                                                  frontierBytes(frontier.size(), n)});
+        int64_t size = 0, frontierEdges = 0, broadcastBytes = 0;
+        for (int s = 0; s < P; s++)
+        {
+            size += stats[3 * s];
+            frontierEdges += stats[3 * s + 1];
+            broadcastBytes += (P - 1) * stats[3 * s + 2];
+        }
+        if (size == 0)
+            break;
+
+        int64_t before = t.bytesSent;
+        bool bottomUp = oneD && opt.bottomUp && broadcastBytes < 8 * frontierEdges &&
+                        frontierEdges > unexplored / opt.alpha;
+        unexplored -= frontierEdges;
+        if (oneD)
+            scanned += myEdges;
+        next.clear();
+
+        if (bottomUp)
+        {
+            encodeFrontier(frontier, n, msg);
+            for (int d = 0; d < P; d++)
+                send[d] = msg;
+            t.exchange(send, recv);
+
+            inFrontier.assign((part.V + 63) / 64, 0);
+            for (int s = 0; s < P; s++)
+            {
+                int64_t base = part.lo(s);
+                decodeFrontier(recv[s], [&](int x)
+                {
+                    int64_t v = base + x;
+                    inFrontier[v >> 6] |= 1ULL << (v & 63);
+                });
+            }
+
+            // Unvisited owned vertices look for any neighbor in the frontier
+#pragma omp parallel
+            {
+                std::vector<int> local;
+
+#pragma omp for schedule(dynamic, 1024)
+                for (int64_t v = 0; v < n; v++)
+                {
+                    if (r.level[v] >= 0)
+                        continue;
+                    for (int64_t e = g.offsets[v]; e < g.offsets[v + 1]; e++)
+                    {
+                        int w = g.targets[e];
+                        if ((inFrontier[w >> 6] >> (w & 63)) & 1)
+                        {
+                            r.level[v] = depth + 1;
+                            r.parent[v] = w;
+                            local.push_back(v);
+                            break;
+                        }
+                    }
+                }
+
+#pragma omp critical
+                next.insert(next.end(), local.begin(), local.end());
+            }
+        }
+        else
+        {
+            // Expand: the frontiers of my grid column become the sources to scan
+            sources.clear();
+            if (oneD)
+            {
+                for (int v : frontier)
+                    sources.push_back((int)(lo + v));
+            }
+            else
+            {
+                encodeFrontier(frontier, n, msg);
+                for (int d = 0; d < P; d++)
+                    send[d].clear();
+                for (int row = 0; row < part.R; row++)
+                    send[row * part.C + column] = msg;
+                t.exchange(send, recv);
+                for (int s = column; s < P; s += part.C)
+                {
+                    int64_t base = part.lo(s);
+                    decodeFrontier(recv[s], [&](int x) { sources.push_back((int)(base + x)); });
+                }
+            }
+
+            // Fold: newly reached targets go to their owners as (vertex, parent) pairs
+            for (int d = 0; d < P; d++)
+                send[d].clear();
+            int64_t width = sources.size();
+#pragma omp parallel
+            {
+                std::vector<std::vector<int>> out(P);
+                int64_t localScanned = 0;
+
+#pragma omp for schedule(dynamic, 64)
+                for (int64_t k = 0; k < width; k++)
+                {
+                    int u = sources[k];
+                    int64_t s = part.sourceIndex(u);
+                    localScanned += g.offsets[s + 1] - g.offsets[s];
+                    for (int64_t e = g.offsets[s]; e < g.offsets[s + 1]; e++)
+                    {
+                        int v = g.targets[e];
+                        if (claimed.claim((int)part.targetIndex(v)))
+                        {
+                            std::vector<int> &o = out[part.owner(v)];
+                            o.push_back(v);
+                            o.push_back(u);
+                        }
+                    }
+                }
+
+#pragma omp critical
+                {
+                    for (int d = 0; d < P; d++)
+                        appendInts(send[d], out[d].data(), out[d].size());
+                    if (!oneD)
+                        scanned += localScanned;
+                }
+            }
+
+            if (part.C > 1)
+                t.exchange(send, recv);
+            else
+            {
+                recv.assign(P, std::vector<uint8_t>()); // every target is my own
+                recv[me].swap(send[me]);
+            }
+
+            for (int s = 0; s < P; s++)
+                for (size_t k = 0; k < recv[s].size(); k += 8)
+                {
+                    int vu[2];
+                    memcpy(vu, recv[s].data() + k, 8);
+                    int v = (int)(vu[0] - lo);
+                    if (r.level[v] < 0)
+                    {
+                        r.level[v] = depth + 1;
+                        r.parent[v] = vu[1];
+                        next.push_back(v);
+                    }
+                }
+        }
+
+        r.direction.push_back(bottomUp ? 'B' : 'T');
+        r.levelBytes.push_back(t.bytesSent - before);
+        frontier.swap(next);
+    }
+
+    // Totals over all ranks in one collective
+    int64_t reached = 0;
+    for (int64_t v = 0; v < n; v++)
+        reached += r.level[v] >= 0;
+    std::vector<int64_t> mine = {reached, scanned, t.bytesSent - startBytes};
+    mine.insert(mine.end(), r.levelBytes.begin(), r.levelBytes.end());
+    std::vector<int64_t> all = t.allgather(mine);
+
+    size_t k = mine.size();
+    r.reached = r.edges = r.bytes = 0;
+    std::fill(r.levelBytes.begin(), r.levelBytes.end(), 0);
+    for (int s = 0; s < P; s++)
+    {
+        r.reached += all[s * k];
+        r.edges += all[s * k + 1];
+        r.bytes += all[s * k + 2];
+        for (size_t d = 0; d < r.levelBytes.size(); d++)
+            r.levelBytes[d] += all[s * k + 3 + d];
+    }
+    r.edges /= 2;
+}
+
+#endif
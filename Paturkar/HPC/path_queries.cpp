@@ -0,0 +1,123 @@
+/*
+ * Problem Statement:
+ * Answer "how far is t from s?" queries between two given vertices without exploring
+ * the whole graph from s (pathquery.h), and compare the latency with a full BFS.
+ *
+ * A graph from generators.h is built once; then random (s, t) pairs are answered by
+ * bidirectional BFS with one reused PathQueryScratch. Every answer is checked against a
+ * full levelSyncBFS from s (bfs.h): same distance, and the returned path must be a real
+ * path of that length. Finally the whole batch is answered in parallel with
+ * pathDistances() to measure the throughput.
+ *
+ * How to run:
+ * 1. Open terminal in the directory containing the file (graph.h, bfs.h, pathquery.h,
+ *    generators.h next to it)
+ * 2. Compile: g++ -O2 -fopenmp path_queries.cpp -o path_queries
+ * 3. Run: ./path_queries [rmat|grid2d|regular] [scale] [queries]
+ *    e.g. ./path_queries rmat 20 200
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <omp.h>
+#include "graph.h"
+#include "bfs.h"
+#include "pathquery.h"
+#include "generators.h"
+
+using namespace std;
+
+// The path starts at s, ends at t, has distance edges and follows real edges
+bool validPath(const Graph &g, int s, int t, const PathResult &r)
+{
+    if (r.distance < 0)
+        return r.path.empty();
+    if ((int)r.path.size() != r.distance + 1 || r.path.front() != s || r.path.back() != t)
+        return false;
+    for (int i = 0; i < r.distance; i++)
+        if (find(g.begin(r.path[i]), g.end(r.path[i]), r.path[i + 1]) == g.end(r.path[i]))
+            return false;
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    string gen = argc > 1 ? argv[1] : "rmat";
+    int scale = argc > 2 ? atoi(argv[2]) : 18;
+    int numQueries = argc > 3 ? atoi(argv[3]) : 100;
+    if (scale < 2 || scale > 28 || numQueries < 1)
+    {
+        cout << "Usage: " << argv[0] << " [rmat|grid2d|regular] [scale] [queries]" << endl;
+        return 1;
+    }
+
+    int V = 1 << scale; // rmat and grid2d overwrite it
+    EdgeList edges;
+    if (gen == "rmat")
+        edges = rmatEdges(scale, 16, V);
+    else if (gen == "grid2d")
+        edges = grid2DEdges(1 << (scale / 2), V);
+    else if (gen == "regular")
+        edges = randomRegularEdges(1 << scale, 8, 1);
+    else
+    {
+        cout << "Unknown generator " << gen << " (use rmat, grid2d or regular)" << endl;
+        return 1;
+    }
+    Graph g = Graph::fromEdges(V, edges);
+    cout << gen << ": " << g.V << " vertices, " << g.numEdges() / 2 << " edges" << endl;
+
+    // Random pairs of vertices that have edges
+    vector<pair<int, int>> queries;
+    uint64_t x = 12345;
+    while ((int)queries.size() < numQueries)
+    {
+        int s = (int)(splitmix64(x) % g.V), t = (int)(splitmix64(x) % g.V);
+        if (g.degree(s) > 0 && g.degree(t) > 0)
+            queries.push_back({s, t});
+    }
+
+    PathQueryScratch scratch;
+    PathResult r;
+    BFSResult full;
+    double queryTime = 0, fullTime = 0;
+    int64_t explored = 0, fullReached = 0;
+    int bad = 0, unreachable = 0;
+    vector<int> answers;
+    for (const pair<int, int> &st : queries)
+    {
+        double t0 = omp_get_wtime();
+        shortestPath(g, st.first, st.second, scratch, r);
+        double t1 = omp_get_wtime();
+        levelSyncBFS(g, st.first, full);
+        double t2 = omp_get_wtime();
+
+        queryTime += t1 - t0;
+        fullTime += t2 - t1;
+        explored += r.explored;
+        fullReached += full.order.size();
+        unreachable += r.distance < 0;
+        answers.push_back(r.distance);
+        if (r.distance != full.level[st.second] || !validPath(g, st.first, st.second, r))
+            bad++;
+    }
+
+    cout << "Bidirectional BFS: " << queryTime / numQueries * 1e6 << " us per query, " << explored / numQueries
+         << " vertices explored on average" << endl;
+    cout << "Full BFS from s:   " << fullTime / numQueries * 1e6 << " us per query, " << fullReached / numQueries
+         << " vertices reached on average" << endl;
+    cout << "Speedup: " << fullTime / queryTime << "x, " << unreachable << " unreachable pairs, " << bad
+         << " answers differ from the full BFS" << endl;
+
+    double t0 = omp_get_wtime();
+    vector<int> distance = pathDistances(g, queries);
+    double batchTime = omp_get_wtime() - t0;
+    cout << "Parallel batch (" << omp_get_max_threads() << " threads): " << numQueries / batchTime
+         << " queries per second, " << (distance == answers ? "same distances" : "DIFFERENT distances") << endl;
+    if (distance != answers)
+        bad++;
+    return bad == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/*
+ * Point-to-point shortest-path queries (unweighted) on the graphs of graph.h.
+ *
+ * shortestPath(g, s, t, scratch) / shortestPath(g, s, t, scratch, result)
+ *   Bidirectional BFS: one search grows from s, one from t, and every step expands the
+ *   whole current level of the side whose frontier has fewer edges to scan. The query
+ *   stops at the first vertex reached from both sides. That first meeting is already a
+ *   shortest path: without a meeting so far, dist(s, t) > ds + dt for the finished
+ *   levels ds and dt, and the new meeting has length ds + 1 + dt.
+ *   On graphs with small diameter each side only explores about the square root of
+ *   what a full BFS from s would touch.
+ *
+ * PathQueryScratch
+ *   The per-query state (visited marks, parents, frontiers), allocated once and reused.
+ *   A vertex counts as visited only if its stamp equals the current generation, so a new
+ *   query just increments the generation instead of clearing or reallocating O(V)
+ *   arrays: the cost of a query depends on the region it explores, not on V. Use one
+ *   scratch per thread.
+ *
+ * pathDistances(g, queries)
+ *   Answers a batch of (s, t) queries in parallel, one scratch per thread.
+ *
+ * G is Graph or any graph with the same interface (see levelSyncBFS in bfs.h).
+ */
+
+#ifndef PATHQUERY_H
+#define PATHQUERY_H
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+struct PathResult
+{
+    int distance = -1;     // number of edges, -1 if t is not reachable from s
+    std::vector<int> path; // s .. t, empty if unreachable
+    int64_t explored = 0;  // vertices visited by both searches together
+};
+
+struct PathQueryScratch
+{
+    std::vector<uint32_t> stamp[2]; // stamp[side][v] == generation: v reached from that side
+    std::vector<int> parent[2];     // valid where stamped; side 0 grows from s, side 1 from t
+    std::vector<int> frontier[2], next;
+    uint32_t generation = 0;
+
+    // Starts a new query; only allocates on the first query (or when V changes)
+    void prepare(int V)
+    {
+        if ((int)stamp[0].size() != V)
+        {
+            for (int side = 0; side < 2; side++)
+            {
+                stamp[side].assign(V, 0);
+                parent[side].assign(V, -1);
+            }
+            generation = 0;
+        }
+        if (++generation == 0) // wrapped around: old stamps could look current
+        {
+            for (int side = 0; side < 2; side++)
+                std::fill(stamp[side].begin(), stamp[side].end(), 0);
+            generation = 1;
+        }
+        frontier[0].clear();
+        frontier[1].clear();
+    }
+
+    bool seen(int side, int v) const { return stamp[side][v] == generation; }
+
+    void mark(int side, int v, int p)
+    {
+        stamp[side][v] = generation;
+        parent[side][v] = p;
+    }
+};
+
+template <class G>
+void shortestPath(const G &g, int s, int t, PathQueryScratch &q, PathResult &r)
+{
+    r.distance = -1;
+    r.path.clear();
+    r.explored = 0;
+    if (s < 0 || t < 0 || s >= g.V || t >= g.V)
+        return;
+    if (s == t)
+    {
+        r.distance = 0;
+        r.path.push_back(s);
+        r.explored = 1;
+        return;
+    }
+
+    q.prepare(g.V);
+    q.mark(0, s, -1);
+    q.mark(1, t, -1);
+    q.frontier[0].push_back(s);
+    q.frontier[1].push_back(t);
+    int64_t frontierEdges[2] = {g.degree(s), g.degree(t)};
+    int levels[2] = {0, 0};
+    int meetAt = -1;
+    r.explored = 2;
+
+    while (meetAt < 0 && !q.frontier[0].empty() && !q.frontier[1].empty())
+    {
+        int side = frontierEdges[0] <= frontierEdges[1] ? 0 : 1, other = 1 - side;
+        q.next.clear();
+        int64_t nextEdges = 0;
+
+        for (size_t i = 0; i < q.frontier[side].size() && meetAt < 0; i++)
+        {
+            int u = q.frontier[side][i];
+            for (auto p = g.begin(u), last = g.end(u); p != last; ++p)
+            {
+                int w = *p;
+                if (q.seen(side, w))
+                    continue;
+                q.mark(side, w, u);
+                r.explored++;
+                if (q.seen(other, w))
+                {
+                    meetAt = w;
+                    break;
+                }
+                q.next.push_back(w);
+                nextEdges += g.degree(w);
+            }
+        }
+
+        levels[side]++;
+        q.frontier[side].swap(q.next);
+        frontierEdges[side] = nextEdges;
+    }
+
+    if (meetAt < 0)
+        return;
+    r.distance = levels[0] + levels[1];
+
+    // meetAt is stamped from both sides: walk its side-0 parents back to s and its
+    // side-1 parents on to t
+    for (int v = meetAt; v >= 0; v = q.parent[0][v])
+        r.path.push_back(v);
+    std::reverse(r.path.begin(), r.path.end());
+    for (int v = q.parent[1][meetAt]; v >= 0; v = q.parent[1][v])
+        r.path.push_back(v);
+}
+
+template <class G>
+PathResult shortestPath(const G &g, int s, int t, PathQueryScratch &q)
+{
+    PathResult r;
+    shortestPath(g, s, t, q, r);
+    return r;
+}
+
+// Distance of every (s, t) query, -1 if unreachable; queries run in parallel
+template <class G>
+std::vector<int> pathDistances(const G &g, const std::vector<std::pair<int, int>> &queries)
+{
+    std::vector<int> distance(queries.size(), -1);
+
+#pragma omp parallel
+    {
+        PathQueryScratch q;
+        PathResult r;
+
+#pragma omp for schedule(dynamic, 16)
+        for (int64_t i = 0; i < (int64_t)queries.size(); i++)
+        {
+            shortestPath(g, queries[i].first, queries[i].second, q, r);
+            distance[i] = r.distance;
+        }
+    }
+    return distance;
+}
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * Parallel LSD radix sort for arrays of integers (signed or unsigned, 8 to 64 bits).
+ *
+ * parallelRadixSort(a) / parallelRadixSort(a, n, scratch)
+ *   Sorts by 8-bit digits, least significant first; one pass per digit moves every key
+ *   from one buffer to the other (ping-pong, one copy back at the end if the number of
+ *   passes is odd). Signed keys are sorted by flipping the sign bit, which maps them to
+ *   unsigned keys in the same order. Returns the number of passes that ran.
+ *
+ *   Every thread owns one fixed chunk of the array for the whole sort:
+ *   - One initial read of the chunk counts all digits at once. Summed over the threads
+ *     this gives the histogram of every digit of the whole array, which does not change
+ *     between passes; a digit whose keys all fall into one bucket (e.g. the high bytes of
+ *     small values) is skipped without touching the data.
+ *   - Every pass counts the current digit of the chunk in a per-thread histogram; a
+ *     parallel prefix sum over (bucket, thread) gives every thread its own write
+ *     position in every bucket, so the scatter needs no synchronization and is stable.
+ *   - The scatter goes through software write-combining buffers: one cache line of keys
+ *     per bucket and thread, flushed to the destination when full. The writes then go
+ *     out a cache line at a time to 256 streams instead of one key at a time to 256
+ *     random places.
+ *
+ * Inputs below RADIX_MIN_SIZE are sorted with std::sort.
+ */
+
+#ifndef RADIXSORT_H
+#define RADIXSORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+#include <omp.h>
+
+const int64_t RADIX_MIN_SIZE = 1 << 12;
+const int RADIX_BUCKETS = 256;
+
+// Unsigned image of a key with the same order: the sign bit is flipped for signed types
+template <class T>
+inline typename std::make_unsigned<T>::type radixBits(T x)
+{
+    typedef typename std::make_unsigned<T>::type U;
+    U u = (U)x;
+    if (std::is_signed<T>::value)
+        u ^= (U)1 << (sizeof(T) * 8 - 1);
+    return u;
+}
+
+template <class T>
+inline int radixDigit(T x, int pass)
+{
+    return (int)((radixBits(x) >> (8 * pass)) & (RADIX_BUCKETS - 1));
+}
+
+template <class T>
+int parallelRadixSort(T *a, int64_t n, T *scratch)
+{
+    static_assert(std::is_integral<T>::value, "parallelRadixSort needs integer keys");
+    const int passes = sizeof(T);
+    if (n < RADIX_MIN_SIZE)
+    {
+        std::sort(a, a + n);
+        return 0;
+    }
+
+    // Keys per write-combining buffer: one 64-byte cache line
+    const int WC = 64 / sizeof(T) > 0 ? 64 / sizeof(T) : 1;
+    int maxThreads = omp_get_max_threads();
+    std::vector<int64_t> total((size_t)passes * RADIX_BUCKETS, 0); // whole-array digit histograms
+    std::vector<int64_t> offset((size_t)maxThreads * RADIX_BUCKETS), bucketStart(RADIX_BUCKETS);
+    T *src = a, *dst = scratch;
+    int done = 0;
+
+#pragma omp parallel num_threads(maxThreads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        int64_t lo = n * t / nt, hi = n * (t + 1) / nt;
+
+        std::vector<int64_t> local((size_t)passes * RADIX_BUCKETS, 0);
+        for (int64_t i = lo; i < hi; i++)
+        {
+            typename std::make_unsigned<T>::type u = radixBits(a[i]);
+            for (int d = 0; d < passes; d++)
+                local[d * RADIX_BUCKETS + ((u >> (8 * d)) & (RADIX_BUCKETS - 1))]++;
+        }
+        for (size_t k = 0; k < local.size(); k++)
+            if (local[k])
+                __atomic_fetch_add(&total[k], local[k], __ATOMIC_RELAXED);
+
+        std::vector<T> buffer((size_t)RADIX_BUCKETS * WC);
+        int fill[RADIX_BUCKETS];
+        int64_t *my = &offset[(size_t)t * RADIX_BUCKETS];
+#pragma omp barrier
+
+        for (int d = 0; d < passes; d++)
+        {
+            // Same decision on every thread: total is read-only from here on
+            const int64_t *h = &total[d * RADIX_BUCKETS];
+            if (*std::max_element(h, h + RADIX_BUCKETS) == n)
+                continue;
+
+            std::fill(my, my + RADIX_BUCKETS, 0);
+            for (int64_t i = lo; i < hi; i++)
+                my[radixDigit(src[i], d)]++;
+#pragma omp barrier
+
+            // Exclusive prefix sum, bucket-major: within a bucket thread 0 writes first
+#pragma omp for schedule(static)
+            for (int b = 0; b < RADIX_BUCKETS; b++)
+            {
+                int64_t sum = 0;
+                for (int k = 0; k < nt; k++)
+                {
+                    int64_t c = offset[(size_t)k * RADIX_BUCKETS + b];
+                    offset[(size_t)k * RADIX_BUCKETS + b] = sum;
+                    sum += c;
+                }
+            }
+#pragma omp single
+            {
+                int64_t sum = 0;
+                for (int b = 0; b < RADIX_BUCKETS; b++)
+                {
+                    bucketStart[b] = sum;
+                    sum += h[b];
+                }
+            }
+            for (int b = 0; b < RADIX_BUCKETS; b++)
+                my[b] += bucketStart[b];
+
+            std::fill(fill, fill + RADIX_BUCKETS, 0);
+            for (int64_t i = lo; i < hi; i++)
+            {
+                T x = src[i];
+                int b = radixDigit(x, d);
+                T *line = &buffer[(size_t)b * WC];
+                line[fill[b]++] = x;
+                if (fill[b] == WC)
+                {
+                    memcpy(dst + my[b], line, WC * sizeof(T));
+                    my[b] += WC;
+                    fill[b] = 0;
+                }
+            }
+            for (int b = 0; b < RADIX_BUCKETS; b++)
+                if (fill[b] > 0)
+                    memcpy(dst + my[b], &buffer[(size_t)b * WC], fill[b] * sizeof(T));
+
+#pragma omp barrier
+#pragma omp single
+            {
+                std::swap(src, dst);
+                done++;
+            }
+        }
+
+        // Odd number of passes: the result is in scratch
+        if (src != a)
+            memcpy(a + lo, src + lo, (hi - lo) * sizeof(T));
+    }
+    return done;
+}
+
+template <class T>
+int parallelRadixSort(std::vector<T> &a)
+{
+    std::vector<T> scratch(a.size());
+    return parallelRadixSort(a.data(), (int64_t)a.size(), scratch.data());
+}
+
+#endif
@@ -0,0 +1,252 @@
+/*
+ * Locality-improving vertex reorderings for the CSR Graph from graph.h.
+ *
+ * The vertex ids of an input graph usually come from an external numbering, so the
+ * visited[v] / offsets[v] reads of a traversal land almost at random in memory.
+ * Renumbering the vertices once at load time puts vertices that are visited together
+ * next to each other:
+ *
+ *   DegreeSorted        - high-degree (hot) vertices first, packed into few cache lines
+ *   ReverseCuthillMcKee - BFS from a low-degree vertex, neighbors by increasing degree,
+ *                         reversed; keeps every edge's endpoints close (small bandwidth)
+ *   BFSOrder            - plain BFS visit order, component by component
+ *
+ * Usage:
+ *   Reordering ro = reorder(g, Ordering::ReverseCuthillMcKee);
+ *   BFSResult r = levelSyncBFS(ro.graph, ro.newId[start]);
+ *   r = toOriginalIds(ro, r);   // report results in the original vertex ids
+ */
+
+#ifndef REORDER_H
+#define REORDER_H
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+#include "bfs.h"
+#include "dfs.h"
+
+enum class Ordering
+{
+    Original,
+    DegreeSorted,
+    ReverseCuthillMcKee,
+    BFSOrder
+};
+
+inline const char *orderingName(Ordering o)
+{
+    switch (o)
+    {
+    case Ordering::DegreeSorted:
+        return "degree";
+    case Ordering::ReverseCuthillMcKee:
+        return "rcm";
+    case Ordering::BFSOrder:
+        return "bfs";
+    default:
+        return "original";
+    }
+}
+
+// Parses "original", "degree", "rcm" or "bfs"; returns false for anything else
+inline bool parseOrdering(const char *name, Ordering &o)
+{
+    for (Ordering c : {Ordering::Original, Ordering::DegreeSorted, Ordering::ReverseCuthillMcKee, Ordering::BFSOrder})
+        if (strcmp(name, orderingName(c)) == 0)
+        {
+            o = c;
+            return true;
+        }
+    return false;
+}
+
+struct Reordering
+{
+    std::vector<int> newId; // newId[original vertex] = vertex id in graph
+    std::vector<int> oldId; // oldId[vertex id in graph] = original vertex
+    Graph graph;            // the renumbered graph
+};
+
+// Vertices by decreasing degree (counting sort on the degree, stable within a degree)
+inline std::vector<int> degreeOrder(const Graph &g)
+{
+    int maxDegree = 0;
+#pragma omp parallel for reduction(max : maxDegree)
+    for (int u = 0; u < g.V; u++)
+        maxDegree = std::max(maxDegree, g.degree(u));
+
+    std::vector<int64_t> start(maxDegree + 2, 0);
+    for (int u = 0; u < g.V; u++)
+        start[maxDegree - g.degree(u) + 1]++;
+    for (int d = 0; d <= maxDegree; d++)
+        start[d + 1] += start[d];
+
+    std::vector<int> order(g.V);
+    for (int u = 0; u < g.V; u++)
+        order[start[maxDegree - g.degree(u)]++] = u;
+    return order;
+}
+
+// BFS visit order over all components; with byDegree set, every vertex's unvisited
+// neighbors are queued by increasing degree and each component starts from its
+// lowest-degree vertex (Cuthill-McKee)
+inline std::vector<int> bfsOrder(const Graph &g, bool byDegree = false)
+{
+    std::vector<int> order;
+    order.reserve(g.V);
+    std::vector<char> visited(g.V, 0);
+
+    std::vector<int> seeds;
+    if (byDegree)
+    {
+        seeds = degreeOrder(g);
+        std::reverse(seeds.begin(), seeds.end());
+    }
+    else
+    {
+        seeds.resize(g.V);
+        for (int u = 0; u < g.V; u++)
+            seeds[u] = u;
+    }
+
+    for (int seed : seeds)
+    {
+        if (visited[seed])
+            continue;
+        visited[seed] = 1;
+        size_t head = order.size();
+        order.push_back(seed);
+
+        while (head < order.size())
+        {
+            int u = order[head++];
+            size_t first = order.size();
+            for (const int *p = g.begin(u); p != g.end(u); ++p)
+                if (!visited[*p])
+                {
+                    visited[*p] = 1;
+                    order.push_back(*p);
+                }
+            if (byDegree)
+                std::sort(order.begin() + first, order.end(),
+                          [&g](int a, int b) { return g.degree(a) < g.degree(b); });
+        }
+    }
+    return order;
+}
+
+inline std::vector<int> rcmOrder(const Graph &g)
+{
+    std::vector<int> order = bfsOrder(g, true);
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Builds the graph renumbered so that vertex i is oldId[i]; neighbor lists come out sorted
+inline Graph permuteGraph(const Graph &g, const std::vector<int> &oldId, const std::vector<int> &newId)
+{
+    Graph h(g.V);
+
+#pragma omp parallel for
+    for (int i = 0; i < g.V; i++)
+        h.offsetStore[i + 1] = g.degree(oldId[i]);
+    parallelPrefixSum(h.offsetStore.data() + 1, g.V);
+
+    h.neighborStore.resize(h.offsetStore[g.V]);
+
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int i = 0; i < g.V; i++)
+    {
+        int *out = h.neighborStore.data() + h.offsetStore[i];
+        int *p = out;
+        for (const int *q = g.begin(oldId[i]); q != g.end(oldId[i]); ++q)
+            *p++ = newId[*q];
+        std::sort(out, p);
+    }
+
+    h.rebind();
+    return h;
+}
+
+inline Reordering reorder(const Graph &g, Ordering o)
+{
+    Reordering ro;
+    switch (o)
+    {
+    case Ordering::DegreeSorted:
+        ro.oldId = degreeOrder(g);
+        break;
+    case Ordering::ReverseCuthillMcKee:
+        ro.oldId = rcmOrder(g);
+        break;
+    case Ordering::BFSOrder:
+        ro.oldId = bfsOrder(g);
+        break;
+    default:
+        ro.oldId.resize(g.V);
+        for (int u = 0; u < g.V; u++)
+            ro.oldId[u] = u;
+        break;
+    }
+
+    ro.newId.resize(g.V);
+#pragma omp parallel for
+    for (int i = 0; i < g.V; i++)
+        ro.newId[ro.oldId[i]] = i;
+
+    ro.graph = o == Ordering::Original ? g : permuteGraph(g, ro.oldId, ro.newId);
+    return ro;
+}
+
+// Translates a BFS result on ro.graph back to the original vertex ids
+inline BFSResult toOriginalIds(const Reordering &ro, const BFSResult &r)
+{
+    BFSResult out = r;
+    int V = (int)ro.oldId.size();
+
+#pragma omp parallel for
+    for (int i = 0; i < V; i++)
+    {
+        int u = ro.oldId[i];
+        out.level[u] = r.level[i];
+        out.parent[u] = r.parent[i] < 0 ? -1 : ro.oldId[r.parent[i]];
+    }
+
+#pragma omp parallel for
+    for (size_t k = 0; k < r.order.size(); k++)
+        out.order[k] = ro.oldId[r.order[k]];
+
+    return out;
+}
+
+// Translates a DFS result on ro.graph back to the original vertex ids
+inline DFSResult toOriginalIds(const Reordering &ro, const DFSResult &r)
+{
+    DFSResult out = r;
+    int V = (int)ro.oldId.size();
+
+#pragma omp parallel for
+    for (int i = 0; i < V; i++)
+    {
+        int u = ro.oldId[i];
+        out.parent[u] = r.parent[i] < 0 ? -1 : ro.oldId[r.parent[i]];
+        out.depth[u] = r.depth[i];
+        out.discovery[u] = r.discovery[i];
+        out.finish[u] = r.finish[i];
+    }
+
+#pragma omp parallel for
+    for (size_t k = 0; k < r.order.size(); k++)
+        out.order[k] = ro.oldId[r.order[k]];
+
+#pragma omp parallel for
+    for (size_t k = 0; k < r.postorder.size(); k++)
+        out.postorder[k] = ro.oldId[r.postorder[k]];
+
+    return out;
+}
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * Problem Statement:
+ * Measure how much each vertex reordering in reorder.h (degree-sorted, Reverse
+ * Cuthill-McKee, BFS order) speeds up BFS and DFS on a given graph.
+ *
+ * For every ordering the program reports the time to compute the ordering, the best
+ * of several runs of parallel BFS (levelSyncBFS) and of sequential DFS (sequentialDFS
+ * from dfs.h), and the speedup of both traversals over the original numbering. BFS levels are mapped back
+ * to the original ids and checked against the original ordering.
+ *
+ * How to run:
+ * 1. Open terminal in the directory containing the file (graph.h, bfs.h, dfs.h, reorder.h next to it)
+ * 2. Compile: g++ -O2 -fopenmp reorder_report.cpp -o reorder_report
+ * 3. Run: ./reorder_report graph.csr [start vertex] [runs]
+ *    (graph.csr is a snapshot made by graph_convert.cpp)
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <omp.h>
+#include "graph.h"
+#include "bfs.h"
+#include "dfs.h"
+#include "reorder.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        cout << "Usage: " << argv[0] << " graph.csr [start vertex] [runs]" << endl;
+        return 1;
+    }
+
+    Graph g;
+    if (!loadSnapshot(argv[1], g))
+    {
+        cout << "Could not load snapshot " << argv[1] << endl;
+        return 1;
+    }
+    int start = argc > 2 ? atoi(argv[2]) : 0;
+    int runs = argc > 3 ? atoi(argv[3]) : 3;
+    if (start < 0 || start >= g.V || runs < 1)
+    {
+        cout << "Start vertex must be in [0, " << g.V << ") and runs at least 1" << endl;
+        return 1;
+    }
+
+    cout << "Graph: " << g.V << " vertices, " << g.numEdges() / 2 << " edges, "
+         << omp_get_max_threads() << " threads" << endl;
+    cout << left << setw(10) << "ordering" << setw(14) << "reorder (s)" << setw(12) << "BFS (s)"
+         << setw(12) << "DFS (s)" << setw(14) << "BFS speedup" << setw(14) << "DFS speedup"
+         << "check" << endl;
+
+    vector<int> reference;
+    double baseBFS = 0, baseDFS = 0;
+
+    for (Ordering o : {Ordering::Original, Ordering::DegreeSorted, Ordering::ReverseCuthillMcKee, Ordering::BFSOrder})
+    {
+        double t0 = omp_get_wtime();
+        Reordering ro = reorder(g, o);
+        double reorderTime = omp_get_wtime() - t0;
+
+        int s = ro.newId[start];
+        double bestBFS = 1e30, bestDFS = 1e30;
+        BFSResult r;
+        DFSResult d;
+        DFSVisitor none;
+        for (int i = 0; i < runs; i++)
+        {
+            t0 = omp_get_wtime();
+            r = levelSyncBFS(ro.graph, s);
+            bestBFS = min(bestBFS, omp_get_wtime() - t0);
+
+            t0 = omp_get_wtime();
+            sequentialDFS(ro.graph, s, d, none);
+            bestDFS = min(bestDFS, omp_get_wtime() - t0);
+        }
+
+        r = toOriginalIds(ro, r);
+        if (o == Ordering::Original)
+        {
+            reference = r.level;
+            baseBFS = bestBFS;
+            baseDFS = bestDFS;
+        }
+
+        cout << left << setw(10) << orderingName(o) << setw(14) << reorderTime << setw(12) << bestBFS
+             << setw(12) << bestDFS << setw(14) << baseBFS / bestBFS << setw(14) << baseDFS / bestDFS
+             << (r.level == reference ? "ok" : "MISMATCH") << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * Parallel sample sort for large arrays (any type with operator<; not stable).
+ *
+ * parallelSampleSort(a) / parallelSampleSort(a, n, scratch)
+ *   1. Splitters: a random sample of SAMPLE_OVERSAMPLING keys per bucket is sorted and
+ *      every SAMPLE_OVERSAMPLING-th key becomes a splitter; oversampling keeps every
+ *      bucket close to n / buckets keys. The bucket count is a power of two, at least 4
+ *      per thread, sized so a bucket holds about BUCKET_TARGET keys.
+ *   2. Classification (pass 1 over the data): every thread runs its chunk down a
+ *      SplitterTree, an implicit binary search tree over the splitters. Each of the
+ *      log2(buckets) steps is one comparison turned into an index, i = 2i + (splitter < x),
+ *      so there is no branch to mispredict, and 8 keys go down the tree at the same time
+ *      to hide the load latency. The bucket numbers are kept (2 bytes per key) together
+ *      with per-thread bucket counts.
+ *   3. Distribution (pass 2): a prefix sum over (bucket, thread) gives every thread its
+ *      own write positions, and the keys are scattered into scratch.
+ *   4. The buckets are sorted independently, in parallel, from scratch back into a with
+ *      the merge sort of mergesort.h (SIMD kernels for int); a bucket fits in the cache.
+ *
+ *   Duplicate keys: every tree bucket b has an equality bucket next to it for the keys
+ *   equal to its upper splitter. A key that is frequent enough to be sampled repeatedly
+ *   becomes a splitter and all its copies land in its equality bucket, which needs no
+ *   sorting at all, instead of piling up in one bucket that one thread has to sort.
+ *   Repeated splitters are removed, so the tree shrinks when the keys have few values.
+ *
+ * Inputs below SAMPLE_SORT_MIN are sorted with parallelMergeSort.
+ */
+
+#ifndef SAMPLESORT_H
+#define SAMPLESORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <omp.h>
+#include "mergesort.h"
+
+const int64_t SAMPLE_SORT_MIN = 1 << 16;
+const int SAMPLE_OVERSAMPLING = 16;
+const int MAX_SPLITTER_LEVELS = 10; // at most 1024 tree buckets, 2048 with equality buckets
+const int64_t BUCKET_TARGET = 1 << 16;
+
+struct SampleSortStats
+{
+    int buckets = 0;           // tree and equality buckets
+    int splitters = 0;         // distinct splitters
+    int64_t largestBucket = 0; // keys in the largest bucket that had to be sorted
+    int64_t equalKeys = 0;     // keys in equality buckets
+};
+
+template <class T>
+struct SplitterTree
+{
+    int levels = 0, leaves = 1; // leaves = 2^levels tree buckets
+    std::vector<T> tree;        // tree[1 .. leaves): in order, the sorted (padded) splitters
+    std::vector<T> upper;       // upper[b]: the smallest splitter >= every key of tree bucket b
+
+    // splitters: sorted, without repeats, not empty. Padded with copies of the last one
+    // to leaves - 1, which leaves the padded buckets empty.
+    explicit SplitterTree(const std::vector<T> &splitters)
+    {
+        int m = (int)splitters.size();
+        while (leaves < m + 1)
+        {
+            leaves *= 2;
+            levels++;
+        }
+        upper.resize(leaves);
+        for (int b = 0; b < leaves; b++)
+            upper[b] = splitters[std::min(b, m - 1)];
+
+        // Node i at depth d, position p within its level, is in-order splitter
+        // (2p + 1) * 2^(levels - 1 - d) - 1
+        tree.resize(leaves);
+        for (int i = 1; i < leaves; i++)
+        {
+            int d = 31 - __builtin_clz(i), p = i - (1 << d);
+            tree[i] = upper[(2 * p + 1) * (1 << (levels - 1 - d)) - 1];
+        }
+    }
+
+    // 2 * (number of splitters < x), plus 1 if x equals the bucket's upper splitter (the
+    // last tree bucket has none: its keys are larger than every splitter)
+    int bucketOf(int i, const T &x) const
+    {
+        int b = i - leaves;
+        return 2 * b + ((b < leaves - 1) & !(x < upper[b]));
+    }
+
+    int classify(const T &x) const
+    {
+        int i = 1;
+        for (int l = 0; l < levels; l++)
+            i = 2 * i + (tree[i] < x);
+        return bucketOf(i, x);
+    }
+
+    // Eight keys through the tree level by level: eight independent loads per level
+    void classify8(const T *x, uint16_t *bucket) const
+    {
+        int i[8];
+        for (int j = 0; j < 8; j++)
+            i[j] = 1;
+        for (int l = 0; l < levels; l++)
+            for (int j = 0; j < 8; j++)
+                i[j] = 2 * i[j] + (tree[i[j]] < x[j]);
+        for (int j = 0; j < 8; j++)
+            bucket[j] = (uint16_t)bucketOf(i[j], x[j]);
+    }
+};
+
+template <class T>
+SampleSortStats parallelSampleSort(T *a, int64_t n, T *scratch)
+{
+    SampleSortStats st;
+    if (n < SAMPLE_SORT_MIN)
+    {
+        parallelMergeSort(a, n, scratch);
+        st.buckets = 1;
+        st.largestBucket = n;
+        return st;
+    }
+
+    int maxThreads = omp_get_max_threads();
+    int64_t want = std::max<int64_t>(4 * maxThreads, n / BUCKET_TARGET);
+    int k = 2;
+    while (k < want && k < (1 << MAX_SPLITTER_LEVELS))
+        k *= 2;
+
+    // Oversampled splitters; the sample positions come from a fixed xorshift sequence
+    std::vector<T> sample((size_t)SAMPLE_OVERSAMPLING * k);
+    uint64_t x = 0x9E3779B97F4A7C15ULL ^ (uint64_t)n;
+    for (T &s : sample)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        s = a[x % n];
+    }
+    std::sort(sample.begin(), sample.end());
+    std::vector<T> splitters;
+    for (int j = 1; j < k; j++)
+    {
+        const T &s = sample[(size_t)j * SAMPLE_OVERSAMPLING];
+        if (splitters.empty() || splitters.back() < s)
+            splitters.push_back(s);
+    }
+    SplitterTree<T> tree(splitters);
+    const int B = 2 * tree.leaves;
+    st.buckets = B;
+    st.splitters = (int)splitters.size();
+
+    std::vector<uint16_t> bucket(n);
+    std::vector<int64_t> offset((size_t)maxThreads * B), bucketStart(B + 1);
+    int64_t largest = 0, equalKeys = 0;
+
+#pragma omp parallel num_threads(maxThreads)
+    {
+        int t = omp_get_thread_num(), nt = omp_get_num_threads();
+        int64_t lo = n * t / nt, hi = n * (t + 1) / nt;
+        int64_t *my = &offset[(size_t)t * B];
+        std::fill(my, my + B, 0);
+
+        // Pass 1: classify and count
+        int64_t i = lo;
+        for (; i + 8 <= hi; i += 8)
+        {
+            tree.classify8(a + i, &bucket[i]);
+            for (int j = 0; j < 8; j++)
+                my[bucket[i + j]]++;
+        }
+        for (; i < hi; i++)
+        {
+            bucket[i] = (uint16_t)tree.classify(a[i]);
+            my[bucket[i]]++;
+        }
+#pragma omp barrier
+
+        // Exclusive prefix sum, bucket-major
+#pragma omp for schedule(static)
+        for (int b = 0; b < B; b++)
+        {
+            int64_t sum = 0;
+            for (int s = 0; s < nt; s++)
+            {
+                int64_t c = offset[(size_t)s * B + b];
+                offset[(size_t)s * B + b] = sum;
+                sum += c;
+            }
+            bucketStart[b + 1] = sum; // bucket size for now
+        }
+#pragma omp single
+        {
+            bucketStart[0] = 0;
+            for (int b = 0; b < B; b++)
+                bucketStart[b + 1] += bucketStart[b];
+        }
+        for (int b = 0; b < B; b++)
+            my[b] += bucketStart[b];
+
+        // Pass 2: distribute
+        for (i = lo; i < hi; i++)
+            scratch[my[bucket[i]]++] = a[i];
+#pragma omp barrier
+
+        // Sort every bucket from scratch back into a; equality buckets are only copied
+#pragma omp for schedule(dynamic, 1) reduction(max : largest) reduction(+ : equalKeys)
+        for (int b = 0; b < B; b++)
+        {
+            int64_t first = bucketStart[b], size = bucketStart[b + 1] - first;
+            if (b % 2 == 1)
+            {
+                std::copy(scratch + first, scratch + first + size, a + first);
+                equalKeys += size;
+            }
+            else
+            {
+                mergeSortPingPong(scratch + first, a + first, size, true);
+                largest = std::max(largest, size);
+            }
+        }
+    }
+    st.largestBucket = largest;
+    st.equalKeys = equalKeys;
+    return st;
+}
+
+template <class T>
+SampleSortStats parallelSampleSort(std::vector<T> &a)
+{
+    std::vector<T> scratch(a.size());
+    return parallelSampleSort(a.data(), (int64_t)a.size(), scratch.data());
+}
+
+#endif
@@ -0,0 +1,442 @@
+/*
+ * SIMD sorting kernels for int keys: the leaf and merge stages of mergesort.h.
+ *
+ * sortBlock(src, dst, n)   (n <= SORTNET_BLOCK)
+ *   Sorts src[0 .. n) into dst (src == dst allowed). The block is padded with INT_MAX
+ *   to whole vectors, every vector (8 ints with AVX2, 16 with AVX-512) is sorted in its
+ *   register by a bitonic sorting network, and the sorted vectors are merged pairwise
+ *   with mergeSorted() until one run is left. Everything stays in L1.
+ * mergeSorted(a, na, b, nb, out)
+ *   Bitonic merge kernel: keeps the largest vector of the merge so far in a register;
+ *   every step loads the next vector from the input with the smaller head, merges the two
+ *   sorted registers with a bitonic network (reverse one, min/max, then log2(W) clean-up
+ *   stages) and stores the lower half. The comparisons are min/max instructions, so
+ *   random keys cause one unpredictable branch per vector instead of one per key. The
+ *   last few keys that do not fill a vector are merged with scalar code.
+ *
+ * A network stage is one permute (every lane fetches its partner), one min, one max and
+ * one blend that picks min or max per lane; the stage tables are built once.
+ *
+ * The instruction set is picked at run time (sortNetLevel(), AVX-512 > AVX2 > scalar),
+ * so the file compiles without -mavx2 and the program runs on any x86-64 CPU; the level
+ * can be lowered for comparisons. The scalar level uses insertion sort and a plain merge.
+ * On other architectures (SORTNET_X86 undefined) only the scalar level is compiled.
+ * Equal ints cannot be told apart, so the kernels need not be stable.
+ */
+
+#ifndef SORTNET_H
+#define SORTNET_H
+
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SORTNET_X86
+#include <immintrin.h>
+
+#define SORTNET_AVX2 __attribute__((target("avx2")))
+#define SORTNET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+const int SORTNET_BLOCK = 256;
+
+enum SimdLevel
+{
+    SIMD_SCALAR,
+    SIMD_AVX2,
+    SIMD_AVX512
+};
+
+inline SimdLevel detectSimdLevel()
+{
+#ifdef SORTNET_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+#endif
+    return SIMD_SCALAR;
+}
+
+// The level the kernels use; detected once, may be set lower (never higher) by callers
+inline SimdLevel &sortNetLevel()
+{
+    static SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+inline const char *simdLevelName(SimdLevel level)
+{
+    return level == SIMD_AVX512 ? "AVX-512" : level == SIMD_AVX2 ? "AVX2" : "scalar";
+}
+
+// One compare-exchange stage over W lanes: lane i is compared with lane partner[i] and
+// keeps the max where takeMax[i] is -1, the min where it is 0
+struct NetworkStage
+{
+    int partner[16];
+    int takeMax[16];
+    unsigned maxMask; // the same as a bit mask
+};
+
+// Bitonic sort of one register (log2(W) * (log2(W) + 1) / 2 stages), the clean-up stages
+// that sort a bitonic register (log2(W)) and the lane reversal used by the merge
+template <int W>
+struct BitonicNetwork
+{
+    NetworkStage sort[10], clean[4];
+    int numSort = 0, numClean = 0;
+    int reverse[16];
+
+    BitonicNetwork()
+    {
+        for (int k = 2; k <= W; k *= 2)
+            for (int j = k / 2; j > 0; j /= 2)
+                sort[numSort++] = stage(k, j);
+        for (int j = W / 2; j > 0; j /= 2)
+            clean[numClean++] = stage(W, j);
+        for (int i = 0; i < W; i++)
+            reverse[i] = W - 1 - i;
+    }
+
+    // Lanes i and i ^ j; blocks of k lanes alternate between ascending and descending
+    static NetworkStage stage(int k, int j)
+    {
+        NetworkStage s = {};
+        for (int i = 0; i < W; i++)
+        {
+            int partner = i ^ j;
+            bool ascending = (i & k) == 0 || k == W;
+            bool max = (i > partner) == ascending;
+            s.partner[i] = partner;
+            s.takeMax[i] = max ? -1 : 0;
+            s.maxMask |= (unsigned)max << i;
+        }
+        return s;
+    }
+};
+
+template <int W>
+const BitonicNetwork<W> &bitonicNetwork()
+{
+    static BitonicNetwork<W> net;
+    return net;
+}
+
+// Scalar fallbacks, also used for the tails of the vector kernels
+
+inline void mergeScalar(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+{
+    while (a != aEnd && b != bEnd)
+        *out++ = *b < *a ? *b++ : *a++;
+    out = std::copy(a, aEnd, out);
+    std::copy(b, bEnd, out);
+}
+
+inline void insertionSortScalar(const int *src, int *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; i++)
+    {
+        int x = src[i], j = (int)i;
+        for (; j > 0 && x < dst[j - 1]; j--)
+            dst[j] = dst[j - 1];
+        dst[j] = x;
+    }
+}
+
+// The merge after the vector loop: top holds the W largest keys merged so far, and at
+// least one of the inputs has fewer than W keys left
+inline void mergeTail(const int *top, int W, const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+{
+    if (aEnd - a > bEnd - b)
+    {
+        std::swap(a, b);
+        std::swap(aEnd, bEnd);
+    }
+    int small[32];
+    mergeScalar(top, top + W, a, aEnd, small);
+    mergeScalar(small, small + W + (aEnd - a), b, bEnd, out);
+}
+
+#ifdef SORTNET_X86
+
+// AVX2: 8 ints per register
+
+struct Avx2Network
+{
+    static const int SORT_STAGES = 6, CLEAN_STAGES = 3;
+    __m256i sortPartner[SORT_STAGES], sortMax[SORT_STAGES], cleanPartner[CLEAN_STAGES], cleanMax[CLEAN_STAGES];
+    __m256i reverse;
+
+    SORTNET_AVX2 Avx2Network()
+    {
+        const BitonicNetwork<8> &net = bitonicNetwork<8>();
+        for (int s = 0; s < SORT_STAGES; s++)
+        {
+            sortPartner[s] = _mm256_loadu_si256((const __m256i *)net.sort[s].partner);
+            sortMax[s] = _mm256_loadu_si256((const __m256i *)net.sort[s].takeMax);
+        }
+        for (int s = 0; s < CLEAN_STAGES; s++)
+        {
+            cleanPartner[s] = _mm256_loadu_si256((const __m256i *)net.clean[s].partner);
+            cleanMax[s] = _mm256_loadu_si256((const __m256i *)net.clean[s].takeMax);
+        }
+        reverse = _mm256_loadu_si256((const __m256i *)net.reverse);
+    }
+
+    SORTNET_AVX2 static __m256i exchange(__m256i v, __m256i partner, __m256i takeMax)
+    {
+        __m256i p = _mm256_permutevar8x32_epi32(v, partner);
+        return _mm256_blendv_epi8(_mm256_min_epi32(v, p), _mm256_max_epi32(v, p), takeMax);
+    }
+
+    SORTNET_AVX2 __m256i sortVector(__m256i v) const
+    {
+        for (int s = 0; s < SORT_STAGES; s++)
+            v = exchange(v, sortPartner[s], sortMax[s]);
+        return v;
+    }
+
+    // Sorted lo and hi in, the lower 8 of the 16 keys in lo, the upper 8 in hi, both sorted
+    SORTNET_AVX2 void merge(__m256i &lo, __m256i &hi) const
+    {
+        __m256i r = _mm256_permutevar8x32_epi32(hi, reverse);
+        __m256i l = _mm256_min_epi32(lo, r), h = _mm256_max_epi32(lo, r);
+        for (int s = 0; s < CLEAN_STAGES; s++)
+        {
+            l = exchange(l, cleanPartner[s], cleanMax[s]);
+            h = exchange(h, cleanPartner[s], cleanMax[s]);
+        }
+        lo = l;
+        hi = h;
+    }
+};
+
+SORTNET_AVX2 inline const Avx2Network &avx2Network()
+{
+    static Avx2Network net;
+    return net;
+}
+
+SORTNET_AVX2 inline void mergeAvx2(const int *a, int64_t na, const int *b, int64_t nb, int *out)
+{
+    const int W = 8;
+    const int *aEnd = a + na, *bEnd = b + nb;
+    if (na < W || nb < W)
+    {
+        mergeScalar(a, aEnd, b, bEnd, out);
+        return;
+    }
+    const Avx2Network &net = avx2Network();
+    __m256i lo = _mm256_loadu_si256((const __m256i *)a), hi = _mm256_loadu_si256((const __m256i *)b);
+    a += W;
+    b += W;
+    for (;;)
+    {
+        net.merge(lo, hi);
+        _mm256_storeu_si256((__m256i *)out, lo);
+        out += W;
+
+        // The next vector comes from the input with the smaller head, if it has W keys
+        const int **next;
+        if (a != aEnd && (b == bEnd || *a < *b))
+            next = &a;
+        else if (b != bEnd)
+            next = &b;
+        else
+            break;
+        if ((next == &a ? aEnd : bEnd) - *next < W)
+            break;
+        lo = _mm256_loadu_si256((const __m256i *)*next);
+        *next += W;
+    }
+    alignas(32) int top[W];
+    _mm256_store_si256((__m256i *)top, hi);
+    mergeTail(top, W, a, aEnd, b, bEnd, out);
+}
+
+SORTNET_AVX2 inline void sortBlockAvx2(const int *src, int *dst, int n)
+{
+    const int W = 8;
+    alignas(32) int buf[2][SORTNET_BLOCK];
+    int m = (n + W - 1) / W * W;
+    memcpy(buf[0], src, n * sizeof(int));
+    std::fill(buf[0] + n, buf[0] + m, INT_MAX);
+
+    const Avx2Network &net = avx2Network();
+    for (int i = 0; i < m; i += W)
+        _mm256_store_si256((__m256i *)(buf[0] + i), net.sortVector(_mm256_load_si256((const __m256i *)(buf[0] + i))));
+
+    int from = 0;
+    for (int run = W; run < m; run *= 2, from ^= 1)
+        for (int lo = 0; lo < m; lo += 2 * run)
+        {
+            int mid = std::min(lo + run, m), hi = std::min(lo + 2 * run, m);
+            mergeAvx2(buf[from] + lo, mid - lo, buf[from] + mid, hi - mid, buf[from ^ 1] + lo);
+        }
+    memcpy(dst, buf[from], n * sizeof(int));
+}
+
+// AVX-512: 16 ints per register; the blend is folded into a masked max. (GCC 12 warns
+// about the undefined pass-through operand inside its own AVX-512 intrinsics.)
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+struct Avx512Network
+{
+    static const int SORT_STAGES = 10, CLEAN_STAGES = 4;
+    __m512i sortPartner[SORT_STAGES], cleanPartner[CLEAN_STAGES], reverse;
+    __mmask16 sortMax[SORT_STAGES], cleanMax[CLEAN_STAGES];
+
+    SORTNET_AVX512 Avx512Network()
+    {
+        const BitonicNetwork<16> &net = bitonicNetwork<16>();
+        for (int s = 0; s < SORT_STAGES; s++)
+        {
+            sortPartner[s] = _mm512_loadu_si512(net.sort[s].partner);
+            sortMax[s] = (__mmask16)net.sort[s].maxMask;
+        }
+        for (int s = 0; s < CLEAN_STAGES; s++)
+        {
+            cleanPartner[s] = _mm512_loadu_si512(net.clean[s].partner);
+            cleanMax[s] = (__mmask16)net.clean[s].maxMask;
+        }
+        reverse = _mm512_loadu_si512(net.reverse);
+    }
+
+    SORTNET_AVX512 static __m512i exchange(__m512i v, __m512i partner, __mmask16 takeMax)
+    {
+        __m512i p = _mm512_permutexvar_epi32(partner, v);
+        return _mm512_mask_max_epi32(_mm512_min_epi32(v, p), takeMax, v, p);
+    }
+
+    SORTNET_AVX512 __m512i sortVector(__m512i v) const
+    {
+        for (int s = 0; s < SORT_STAGES; s++)
+            v = exchange(v, sortPartner[s], sortMax[s]);
+        return v;
+    }
+
+    SORTNET_AVX512 void merge(__m512i &lo, __m512i &hi) const
+    {
+        __m512i r = _mm512_permutexvar_epi32(reverse, hi);
+        __m512i l = _mm512_min_epi32(lo, r), h = _mm512_max_epi32(lo, r);
+        for (int s = 0; s < CLEAN_STAGES; s++)
+        {
+            l = exchange(l, cleanPartner[s], cleanMax[s]);
+            h = exchange(h, cleanPartner[s], cleanMax[s]);
+        }
+        lo = l;
+        hi = h;
+    }
+};
+
+SORTNET_AVX512 inline const Avx512Network &avx512Network()
+{
+    static Avx512Network net;
+    return net;
+}
+
+SORTNET_AVX512 inline void mergeAvx512(const int *a, int64_t na, const int *b, int64_t nb, int *out)
+{
+    const int W = 16;
+    const int *aEnd = a + na, *bEnd = b + nb;
+    if (na < W || nb < W)
+    {
+        mergeScalar(a, aEnd, b, bEnd, out);
+        return;
+    }
+    const Avx512Network &net = avx512Network();
+    __m512i lo = _mm512_loadu_si512(a), hi = _mm512_loadu_si512(b);
+    a += W;
+    b += W;
+    for (;;)
+    {
+        net.merge(lo, hi);
+        _mm512_storeu_si512(out, lo);
+        out += W;
+
+        const int **next;
+        if (a != aEnd && (b == bEnd || *a < *b))
+            next = &a;
+        else if (b != bEnd)
+            next = &b;
+        else
+            break;
+        if ((next == &a ? aEnd : bEnd) - *next < W)
+            break;
+        lo = _mm512_loadu_si512(*next);
+        *next += W;
+    }
+    alignas(64) int top[W];
+    _mm512_store_si512(top, hi);
+    mergeTail(top, W, a, aEnd, b, bEnd, out);
+}
+
+SORTNET_AVX512 inline void sortBlockAvx512(const int *src, int *dst, int n)
+{
+    const int W = 16;
+    alignas(64) int buf[2][SORTNET_BLOCK];
+    int m = (n + W - 1) / W * W;
+    memcpy(buf[0], src, n * sizeof(int));
+    std::fill(buf[0] + n, buf[0] + m, INT_MAX);
+
+    const Avx512Network &net = avx512Network();
+    for (int i = 0; i < m; i += W)
+        _mm512_store_si512(buf[0] + i, net.sortVector(_mm512_load_si512(buf[0] + i)));
+
+    int from = 0;
+    for (int run = W; run < m; run *= 2, from ^= 1)
+        for (int lo = 0; lo < m; lo += 2 * run)
+        {
+            int mid = std::min(lo + run, m), hi = std::min(lo + 2 * run, m);
+            mergeAvx512(buf[from] + lo, mid - lo, buf[from] + mid, hi - mid, buf[from ^ 1] + lo);
+        }
+    memcpy(dst, buf[from], n * sizeof(int));
+}
+
+#pragma GCC diagnostic pop
+
+#endif // SORTNET_X86
+
+// Dispatch
+
+inline void sortBlock(const int *src, int *dst, int n)
+{
+    switch (sortNetLevel())
+    {
+#ifdef SORTNET_X86
+    case SIMD_AVX512:
+        sortBlockAvx512(src, dst, n);
+        break;
+    case SIMD_AVX2:
+        sortBlockAvx2(src, dst, n);
+        break;
+#endif
+    default:
+        insertionSortScalar(src, dst, n);
+    }
+}
+
+inline void mergeSorted(const int *a, int64_t na, const int *b, int64_t nb, int *out)
+{
+    switch (sortNetLevel())
+    {
+#ifdef SORTNET_X86
+    case SIMD_AVX512:
+        mergeAvx512(a, na, b, nb, out);
+        break;
+    case SIMD_AVX2:
+        mergeAvx2(a, na, b, nb, out);
+        break;
+#endif
+    default:
+        mergeScalar(a, a + na, b, b + nb, out);
+    }
+}
+
+#endif
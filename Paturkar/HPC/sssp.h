@@ -0,0 +1,394 @@
+/*
+ * Weighted CSR graph and parallel single-source shortest paths.
+ *
+ * WeightedGraph
+ *   The CSR layout of graph.h plus one float weight per stored edge. Every neighbor
+ *   list is sorted by weight, so for any delta the light edges (w <= delta) of a vertex
+ *   are a prefix of its list and the heavy edges the rest: no per-edge branch.
+ *
+ * deltaStepping(g, source) / deltaStepping(g, source, result, opt)
+ *   Delta-stepping (Meyer and Sanders). Tentative distances are grouped into buckets
+ *   of width delta and processed in increasing order:
+ *     - the current bucket's light edges are relaxed over and over until the bucket
+ *       stays empty (a light edge may land back in the same bucket),
+ *     - then the heavy edges of every vertex settled in that bucket are relaxed once
+ *       (they always land in a later bucket).
+ *   Every round uses the machinery of levelSyncBFS (bfs.h): one parallel region, the
+ *   frontier is a shared array, every thread collects what it reaches in private
+ *   buckets, and the private buffers are concatenated with a prefix sum over their
+ *   sizes. Distance and parent are packed into one 64-bit word and lowered together
+ *   with a compare-and-swap (atomic min), so the parent always matches the distance.
+ *   delta = infinity is Bellman-Ford, a small delta approaches Dijkstra; by default it
+ *   is derived from the average weight and degree (tune with SSSPOptions::delta).
+ *
+ * dijkstraSSSP(g, source, result)
+ *   Sequential binary-heap Dijkstra, the reference for results and timings.
+ *
+ * Weights must be non-negative. Unreached vertices get distance +infinity and parent -1.
+ */
+
+#ifndef SSSP_H
+#define SSSP_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+#include <omp.h>
+#include "graph.h"
+
+struct WeightedEdge
+{
+    int u, v;
+    float w;
+};
+
+struct WeightedGraph
+{
+    int V = 0;
+    std::vector<int64_t> offsets; // size V + 1
+    std::vector<int> neighbors;   // size offsets[V]
+    std::vector<float> weights;   // weights[e] belongs to neighbors[e]
+    float maxWeight = 0;
+
+    int degree(int u) const { return (int)(offsets[u + 1] - offsets[u]); }
+    int64_t numEdges() const { return offsets[V]; } // directed entries (2E if undirected)
+
+    // Parallel CSR build (count, prefix sum, scatter), then every list sorted by weight.
+    // Undirected edges are stored in both directions.
+    static WeightedGraph fromEdges(int V, const std::vector<WeightedEdge> &edges, bool directed = false)
+    {
+        WeightedGraph g;
+        g.V = V;
+        g.offsets.assign(V + 1, 0);
+        int64_t m = edges.size();
+
+#pragma omp parallel for
+        for (int64_t i = 0; i < m; i++)
+        {
+            __atomic_fetch_add(&g.offsets[edges[i].u + 1], 1, __ATOMIC_RELAXED);
+            if (!directed)
+                __atomic_fetch_add(&g.offsets[edges[i].v + 1], 1, __ATOMIC_RELAXED);
+        }
+        parallelPrefixSum(g.offsets.data() + 1, V);
+
+        g.neighbors.resize(g.offsets[V]);
+        g.weights.resize(g.offsets[V]);
+        std::vector<int64_t> cursor(g.offsets.begin(), g.offsets.end() - 1);
+
+#pragma omp parallel for
+        for (int64_t i = 0; i < m; i++)
+        {
+            const WeightedEdge &e = edges[i];
+            int64_t pos = __atomic_fetch_add(&cursor[e.u], 1, __ATOMIC_RELAXED);
+            g.neighbors[pos] = e.v;
+            g.weights[pos] = e.w;
+            if (!directed)
+            {
+                pos = __atomic_fetch_add(&cursor[e.v], 1, __ATOMIC_RELAXED);
+                g.neighbors[pos] = e.u;
+                g.weights[pos] = e.w;
+            }
+        }
+
+        g.sortByWeight();
+        return g;
+    }
+
+    // Same topology as an unweighted Graph, with weight(u, v) for every stored edge
+    static WeightedGraph fromGraph(const Graph &graph, const std::function<float(int, int)> &weight)
+    {
+        WeightedGraph g;
+        g.V = graph.V;
+        g.offsets.assign(graph.offsets, graph.offsets + graph.V + 1);
+        g.neighbors.assign(graph.neighbors, graph.neighbors + graph.numEdges());
+        g.weights.resize(graph.numEdges());
+
+#pragma omp parallel for schedule(dynamic, 1024)
+        for (int u = 0; u < g.V; u++)
+            for (int64_t e = g.offsets[u]; e < g.offsets[u + 1]; e++)
+                g.weights[e] = weight(u, g.neighbors[e]);
+
+        g.sortByWeight();
+        return g;
+    }
+
+    // Sorts every neighbor list by (weight, id) and records the largest weight
+    void sortByWeight()
+    {
+        float maxW = 0;
+
+#pragma omp parallel for schedule(dynamic, 256) reduction(max : maxW)
+        for (int u = 0; u < V; u++)
+        {
+            int64_t lo = offsets[u], n = offsets[u + 1] - lo;
+            std::vector<std::pair<float, int>> list(n);
+            for (int64_t i = 0; i < n; i++)
+                list[i] = {weights[lo + i], neighbors[lo + i]};
+            std::sort(list.begin(), list.end());
+            for (int64_t i = 0; i < n; i++)
+            {
+                weights[lo + i] = list[i].first;
+                neighbors[lo + i] = list[i].second;
+                maxW = std::max(maxW, list[i].first);
+            }
+        }
+        maxWeight = maxW;
+    }
+
+    // Average weight scaled down by the average degree: buckets then hold few enough
+    // vertices that little work is repeated, but enough to keep every thread busy
+    float suggestedDelta() const
+    {
+        if (numEdges() == 0)
+            return 1;
+        double sum = 0;
+
+#pragma omp parallel for reduction(+ : sum)
+        for (int64_t e = 0; e < numEdges(); e++)
+            sum += weights[e];
+        double avgWeight = sum / numEdges();
+        double avgDegree = (double)numEdges() / std::max(1, V);
+        return (float)std::max(avgWeight * 4 / std::max(1.0, avgDegree), 1e-6);
+    }
+
+    size_t memoryBytes() const
+    {
+        return (V + 1) * sizeof(int64_t) + numEdges() * (sizeof(int) + sizeof(float));
+    }
+};
+
+// Traversals only fill these arrays and never print; see writer.h for output
+struct SSSPResult
+{
+    std::vector<float> dist;   // shortest distance from the source, +infinity if unreached
+    std::vector<int> parent;   // shortest-path tree parent, -1 for the source and unreached
+    int64_t buckets = 0;       // non-empty buckets processed
+    int64_t lightRounds = 0;   // light-edge rounds over all buckets
+};
+
+struct SSSPOptions
+{
+    float delta = 0; // bucket width; 0 = WeightedGraph::suggestedDelta()
+};
+
+// (distance, parent) in one word. For non-negative floats the bit patterns order the
+// same way as the values, so the distance sits in the high half.
+inline uint64_t packDistance(float d, int parent)
+{
+    uint32_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return (uint64_t)bits << 32 | (uint32_t)parent;
+}
+
+inline float unpackDistance(uint64_t x)
+{
+    uint32_t bits = (uint32_t)(x >> 32);
+    float d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+// Marks u as expanded at distance d; false if it already was (a duplicate queue entry)
+inline bool claimExpansion(uint32_t *slot, float d)
+{
+    uint32_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return __atomic_exchange_n(slot, bits, __ATOMIC_RELAXED) != bits;
+}
+
+// Atomic min: lowers v's distance to d (with parent p) if d is strictly smaller
+inline bool relaxDistance(uint64_t *slot, float d, int p)
+{
+    uint64_t old = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    uint64_t desired = packDistance(d, p);
+    while (d < unpackDistance(old))
+    {
+        if (__atomic_compare_exchange_n(slot, &old, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    }
+    return false;
+}
+
+// Fills r, reusing its buffers across calls
+inline void deltaStepping(const WeightedGraph &g, int source, SSSPResult &r,
+                          const SSSPOptions &opt = SSSPOptions())
+{
+    const float INF = std::numeric_limits<float>::infinity();
+    const float delta = opt.delta > 0 ? opt.delta : g.suggestedDelta();
+
+    // A relaxation from bucket b lands in b .. b + maxWeight / delta, so that many
+    // buckets (plus one) in a ring are enough
+    const int64_t ring = (int64_t)std::min(1e6, std::floor((double)g.maxWeight / delta)) + 2;
+    auto bucketOf = [&](float d) { return (int64_t)(d / delta); };
+
+    std::vector<uint64_t> state(g.V, packDistance(INF, -1));
+    std::vector<int64_t> lightEnd(g.V);        // light edges: [offsets[u], lightEnd[u])
+    std::vector<uint32_t> lightDone(g.V, ~0u); // distance (bits) u's light edges were relaxed at
+    std::vector<uint32_t> heavyDone(g.V, ~0u); // same for the heavy edges
+
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int u = 0; u < g.V; u++)
+        lightEnd[u] = std::upper_bound(g.weights.begin() + g.offsets[u],
+                                       g.weights.begin() + g.offsets[u + 1], delta) - g.weights.begin();
+
+    state[source] = packDistance(0, -1);
+    std::vector<int> frontier(1, source);
+    std::vector<int64_t> writeAt, nextAt;
+    int64_t frontierSize = 1, current = 0, next = 0;
+    r.buckets = 0;
+    r.lightRounds = 0;
+
+#pragma omp parallel
+    {
+        int tid = omp_get_thread_num();
+        int nthreads = omp_get_num_threads();
+        std::vector<std::vector<int>> bins(ring); // private buckets, bins[b % ring]
+        std::vector<int> settled;
+
+#pragma omp single
+        {
+            writeAt.assign(nthreads + 1, 0);
+            nextAt.assign(nthreads, INT64_MAX);
+        }
+
+        // Concatenates every thread's bins[b] into frontier (prefix sum over sizes)
+        auto gather = [&](int64_t b)
+        {
+            std::vector<int> &mine = bins[b % ring];
+            writeAt[tid + 1] = mine.size();
+#pragma omp barrier
+#pragma omp single
+            {
+                for (int t = 0; t < nthreads; t++)
+                    writeAt[t + 1] += writeAt[t];
+                frontierSize = writeAt[nthreads];
+                if ((int64_t)frontier.size() < frontierSize)
+                    frontier.resize(frontierSize);
+            }
+            std::copy(mine.begin(), mine.end(), frontier.begin() + writeAt[tid]);
+            mine.clear();
+#pragma omp barrier
+        };
+
+        // Never files below the current bucket, even if rounding puts nd there
+        auto relaxRange = [&](int u, float du, int64_t lo, int64_t hi)
+        {
+            for (int64_t e = lo; e < hi; e++)
+            {
+                int v = g.neighbors[e];
+                float nd = du + g.weights[e];
+                if (relaxDistance(&state[v], nd, u))
+                    bins[std::max(bucketOf(nd), current) % ring].push_back(v);
+            }
+        };
+
+        while (true)
+        {
+            // Light phase: repeat until no light edge lands in the current bucket
+            while (frontierSize > 0)
+            {
+#pragma omp for schedule(dynamic, 64)
+                for (int64_t i = 0; i < frontierSize; i++)
+                {
+                    int u = frontier[i];
+                    float du = unpackDistance(__atomic_load_n(&state[u], __ATOMIC_RELAXED));
+                    if (!claimExpansion(&lightDone[u], du))
+                        continue; // stale entry: u was already expanded at this distance
+                    settled.push_back(u);
+                    relaxRange(u, du, g.offsets[u], lightEnd[u]);
+                }
+#pragma omp single nowait
+                r.lightRounds++;
+                gather(current);
+            }
+
+            // Heavy phase: the bucket is final, relax the heavy edges of what it settled
+            for (int u : settled)
+            {
+                float du = unpackDistance(__atomic_load_n(&state[u], __ATOMIC_RELAXED));
+                if (claimExpansion(&heavyDone[u], du))
+                    relaxRange(u, du, lightEnd[u], g.offsets[u + 1]);
+            }
+            settled.clear();
+
+            // Next bucket: the smallest non-empty private bucket over all threads (the
+            // current one again only if a heavy edge rounded back into it)
+            int64_t mineNext = INT64_MAX;
+            for (int64_t b = current; b < current + ring; b++)
+                if (!bins[b % ring].empty())
+                {
+                    mineNext = b;
+                    break;
+                }
+            nextAt[tid] = mineNext;
+#pragma omp barrier
+#pragma omp single
+            {
+                next = *std::min_element(nextAt.begin(), nextAt.end());
+                r.buckets += next != current;
+                current = next;
+            }
+            if (next == INT64_MAX)
+                break;
+            gather(next);
+        }
+    }
+
+    r.dist.resize(g.V);
+    r.parent.resize(g.V);
+
+#pragma omp parallel for
+    for (int u = 0; u < g.V; u++)
+    {
+        r.dist[u] = unpackDistance(state[u]);
+        r.parent[u] = (int)(uint32_t)state[u];
+    }
+}
+
+inline SSSPResult deltaStepping(const WeightedGraph &g, int source, const SSSPOptions &opt = SSSPOptions())
+{
+    SSSPResult r;
+    deltaStepping(g, source, r, opt);
+    return r;
+}
+
+// Sequential Dijkstra with a binary heap and lazy deletion
+inline void dijkstraSSSP(const WeightedGraph &g, int source, SSSPResult &r)
+{
+    r.dist.assign(g.V, std::numeric_limits<float>::infinity());
+    r.parent.assign(g.V, -1);
+    r.buckets = r.lightRounds = 0;
+
+    typedef std::pair<float, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    r.dist[source] = 0;
+    heap.push({0, source});
+
+    while (!heap.empty())
+    {
+        Entry top = heap.top();
+        heap.pop();
+        int u = top.second;
+        if (top.first > r.dist[u])
+            continue;
+        for (int64_t e = g.offsets[u]; e < g.offsets[u + 1]; e++)
+        {
+            int v = g.neighbors[e];
+            float nd = top.first + g.weights[e];
+            if (nd < r.dist[v])
+            {
+                r.dist[v] = nd;
+                r.parent[v] = u;
+                heap.push({nd, v});
+            }
+        }
+    }
+}
+
+#endif
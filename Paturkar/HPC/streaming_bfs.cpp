@@ -0,0 +1,100 @@
+/*
+ * Problem Statement:
+ * Keep BFS levels from a fixed root up to date while edges keep arriving, without
+ * re-running the whole BFS after every batch (dynamic.h).
+ *
+ * An R-MAT edge stream (generators.h) is split in two: the first half is loaded as one
+ * big batch, the rest arrives in small batches. After every batch the levels are
+ * refreshed incrementally. Every few batches they are also recomputed from scratch,
+ * both to check them and to compare the latency of the two approaches.
+ *
+ * How to run:
+ * 1. Open terminal in the directory containing the file (dynamic.h, generators.h next to it)
+ * 2. Compile: g++ -O2 -fopenmp streaming_bfs.cpp -o streaming_bfs
+ * 3. Run: ./streaming_bfs [scale] [edge factor] [batch size] [batches]
+ *    e.g. ./streaming_bfs 18 16 1000 50
+ */
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <omp.h>
+#include "dynamic.h"
+#include "generators.h"
+
+using namespace std;
+
+int main(int argc, char *argv[])
+{
+    int scale = argc > 1 ? atoi(argv[1]) : 16;
+    int edgeFactor = argc > 2 ? atoi(argv[2]) : 16;
+    int batchSize = argc > 3 ? atoi(argv[3]) : 1000;
+    int batches = argc > 4 ? atoi(argv[4]) : 20;
+    if (scale < 1 || scale > 30 || edgeFactor < 1 || batchSize < 1 || batches < 1)
+    {
+        cout << "Usage: " << argv[0] << " [scale] [edge factor] [batch size] [batches]" << endl;
+        return 1;
+    }
+
+    int V;
+    EdgeList stream = rmatEdges(scale, edgeFactor, V);
+    size_t initial = stream.size() / 2;
+
+    DynamicGraph g(V);
+    for (size_t i = 0; i < initial; i++)
+        g.addEdge(stream[i].first, stream[i].second);
+    double t0 = omp_get_wtime();
+    g.build();
+    double loadTime = omp_get_wtime() - t0;
+
+    // Root: the highest-degree vertex, which sits in the giant component
+    int root = (int)(max_element(g.deg.begin(), g.deg.end()) - g.deg.begin());
+    IncrementalBFS bfs(root);
+    t0 = omp_get_wtime();
+    bfs.refresh(g);
+    cout << "Initial graph: " << g.V << " vertices, " << g.numEdges() / 2 << " edges, loaded in "
+         << loadTime << " s, first BFS " << omp_get_wtime() - t0 << " s" << endl;
+
+    double insertTotal = 0, refreshTotal = 0, scratchTotal = 0;
+    int64_t affectedTotal = 0;
+    int checks = 0, done = 0;
+    bool ok = true;
+    size_t next = initial;
+
+    for (int b = 0; b < batches && next < stream.size(); b++)
+    {
+        for (int i = 0; i < batchSize && next < stream.size(); i++, next++)
+            g.addEdge(stream[next].first, stream[next].second);
+
+        t0 = omp_get_wtime();
+        g.build();
+        double t1 = omp_get_wtime();
+        bfs.refresh(g);
+        double t2 = omp_get_wtime();
+        insertTotal += t1 - t0;
+        refreshTotal += t2 - t1;
+        affectedTotal += bfs.lastAffected;
+        done++;
+
+        // Every 5th batch: recompute from scratch and compare
+        if (b % 5 == 4 || b == batches - 1 || next == stream.size())
+        {
+            IncrementalBFS scratch(root);
+            t0 = omp_get_wtime();
+            scratch.refresh(g);
+            scratchTotal += omp_get_wtime() - t0;
+            checks++;
+            if (scratch.level != bfs.level)
+                ok = false;
+        }
+    }
+
+    cout << "Batches of " << batchSize << " edges: insert " << insertTotal / done << " s, incremental refresh "
+         << refreshTotal / done << " s (" << affectedTotal / done << " vertices affected on average)" << endl;
+    if (checks > 0)
+        cout << "BFS from scratch: " << scratchTotal / checks << " s, "
+             << "speedup of incremental refresh: " << (scratchTotal / checks) / (refreshTotal / done) << "x" << endl;
+    cout << "Levels " << (ok ? "match" : "DO NOT match") << " a full recomputation" << endl;
+    return ok ? 0 : 1;
+}
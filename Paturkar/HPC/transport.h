@@ -0,0 +1,360 @@
+/*
+ * Message transports for the partitioned BFS (partitioned_bfs.h).
+ *
+ * A Transport connects P ranks (processes) and offers one collective:
+ *   exchange(send, recv)  all-to-all: send[d] is delivered to rank d and recv[s] receives
+ *                         what rank s sent to this rank. Every rank calls it the same
+ *                         number of times; buffers can have any size, including 0.
+ * allgather() / allreduceSum() / allreduceMax() are built on top of it. Algorithms batch
+ * everything they have for one destination into one buffer per step, so the cost of a
+ * message is paid once per destination and step, not once per vertex.
+ *
+ * Both implementations run P processes on one Linux machine. create(P) is called once
+ * before fork(), then attach(rank) in every process after it:
+ *
+ *   SharedMemoryTransport  one anonymous shared mapping holding a P x P grid of mailboxes
+ *                          and a process-shared barrier; buffers larger than a mailbox go
+ *                          through in several rounds
+ *   SocketTransport        one Unix stream socket pair per pair of ranks; all peers are
+ *                          served from one poll() loop, so large exchanges cannot deadlock
+ *
+ * Moving to real nodes only needs another Transport, e.g. exchange() on top of
+ * MPI_Alltoallv; the BFS code does not change.
+ *
+ * bytesSent counts the bytes this rank sent to other ranks (the communication volume).
+ * POSIX only.
+ */
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef std::vector<std::vector<uint8_t>> MessageBuffers;
+
+class Transport
+{
+protected:
+    int P = 1;
+    int me = 0;
+
+public:
+    int64_t bytesSent = 0;
+
+    virtual ~Transport() {}
+
+    // Binds this process to its rank; call once after fork()
+    virtual void attach(int rank) { me = rank; }
+
+    virtual void exchange(const MessageBuffers &send, MessageBuffers &recv) = 0;
+
+    int rank() const { return me; }
+    int size() const { return P; }
+
+    // values of every rank, rank-major: out[r * n + k] is value k of rank r
+    std::vector<int64_t> allgather(const std::vector<int64_t> &values)
+    {
+        size_t bytes = values.size() * sizeof(int64_t);
+        MessageBuffers send(P, std::vector<uint8_t>(bytes)), recv;
+        for (int d = 0; d < P; d++)
+            memcpy(send[d].data(), values.data(), bytes);
+        exchange(send, recv);
+
+        std::vector<int64_t> out(P * values.size());
+        for (int s = 0; s < P; s++)
+            memcpy(out.data() + s * values.size(), recv[s].data(), bytes);
+        return out;
+    }
+
+    int64_t allreduceSum(int64_t x)
+    {
+        std::vector<int64_t> all = allgather({x});
+        int64_t sum = 0;
+        for (int64_t y : all)
+            sum += y;
+        return sum;
+    }
+
+    int64_t allreduceMax(int64_t x)
+    {
+        std::vector<int64_t> all = allgather({x});
+        return *std::max_element(all.begin(), all.end());
+    }
+
+    void barrier() { allgather({}); }
+};
+
+class SharedMemoryTransport : public Transport
+{
+    struct Header
+    {
+        std::atomic<int> arrived;
+        std::atomic<int> phase;
+    };
+
+    uint8_t *region = nullptr;
+    size_t regionBytes = 0;
+    size_t slotBytes = 0;
+
+    Header *header() { return (Header *)region; }
+    int *pending() { return (int *)(region + 64); } // per rank: more rounds needed
+    int64_t *slotSize(int from, int to) { return (int64_t *)(region + slotOffset(from, to)); }
+    uint8_t *slotData(int from, int to) { return region + slotOffset(from, to) + 64; }
+    size_t slotOffset(int from, int to) const
+    {
+        return 64 + ((P * sizeof(int) + 63) / 64) * 64 + ((size_t)from * P + to) * (64 + slotBytes);
+    }
+
+    // Sense-reversing barrier over all ranks; yields while waiting since ranks may
+    // outnumber the cores
+    void wait()
+    {
+        Header *h = header();
+        int phase = h->phase.load(std::memory_order_acquire);
+        if (h->arrived.fetch_add(1, std::memory_order_acq_rel) == P - 1)
+        {
+            h->arrived.store(0, std::memory_order_relaxed);
+            h->phase.store(phase + 1, std::memory_order_release);
+        }
+        else
+        {
+            while (h->phase.load(std::memory_order_acquire) == phase)
+                sched_yield();
+        }
+    }
+
+public:
+    ~SharedMemoryTransport()
+    {
+        if (region)
+            munmap(region, regionBytes);
+    }
+
+    // Maps the mailboxes; mailboxBytes is the largest chunk moved per round and pair
+    bool create(int ranks, size_t mailboxBytes = 1 << 18)
+    {
+        P = ranks;
+        slotBytes = (mailboxBytes + 63) / 64 * 64;
+        regionBytes = slotOffset(P - 1, P - 1) + 64 + slotBytes;
+        void *p = mmap(nullptr, regionBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+        {
+            region = nullptr;
+            return false;
+        }
+        region = (uint8_t *)p;
+        new (region) Header();
+        header()->arrived.store(0);
+        header()->phase.store(0);
+        return true;
+    }
+
+    void exchange(const MessageBuffers &send, MessageBuffers &recv) override
+    {
+        recv.assign(P, std::vector<uint8_t>());
+        recv[me] = send[me];
+        std::vector<size_t> done(P, 0);
+
+        while (true)
+        {
+            int more = 0;
+            for (int d = 0; d < P; d++)
+            {
+                if (d == me)
+                    continue;
+                size_t n = std::min(slotBytes, send[d].size() - done[d]);
+                *slotSize(me, d) = n;
+                memcpy(slotData(me, d), send[d].data() + done[d], n);
+                done[d] += n;
+                bytesSent += n;
+                more |= done[d] < send[d].size();
+            }
+            pending()[me] = more;
+            wait();
+
+            int any = 0;
+            for (int s = 0; s < P; s++)
+            {
+                any |= pending()[s];
+                if (s == me)
+                    continue;
+                const uint8_t *data = slotData(s, me);
+                recv[s].insert(recv[s].end(), data, data + *slotSize(s, me));
+            }
+            wait(); // mailboxes are free again
+            if (!any)
+                break;
+        }
+    }
+};
+
+class SocketTransport : public Transport
+{
+    std::vector<int> fds; // fds[a * P + b]: a's end of the socket pair between a and b
+
+    static void fail(const char *what)
+    {
+        perror(what);
+        exit(1); // a lost peer cannot be recovered from
+    }
+
+public:
+    ~SocketTransport()
+    {
+        for (int fd : fds)
+            if (fd >= 0)
+                close(fd);
+    }
+
+    bool create(int ranks)
+    {
+        P = ranks;
+        fds.assign((size_t)P * P, -1);
+        for (int a = 0; a < P; a++)
+            for (int b = a + 1; b < P; b++)
+            {
+                int sv[2];
+                if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0)
+                    return false;
+                fds[a * P + b] = sv[0];
+                fds[b * P + a] = sv[1];
+            }
+        return true;
+    }
+
+    // Keeps only this rank's ends, non-blocking
+    void attach(int rank) override
+    {
+        me = rank;
+        for (int a = 0; a < P; a++)
+            for (int b = 0; b < P; b++)
+            {
+                int &fd = fds[a * P + b];
+                if (fd < 0)
+                    continue;
+                if (a != me)
+                {
+                    close(fd);
+                    fd = -1;
+                }
+                else
+                    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            }
+    }
+
+    void exchange(const MessageBuffers &send, MessageBuffers &recv) override
+    {
+        recv.assign(P, std::vector<uint8_t>());
+        recv[me] = send[me];
+
+        // Every message is an 8-byte length followed by the payload
+        std::vector<uint64_t> outSize(P), inSize(P, 0);
+        std::vector<size_t> sent(P, 0), got(P, 0);
+        int open = 0;
+        for (int p = 0; p < P; p++)
+        {
+            outSize[p] = send[p].size();
+            if (p != me)
+            {
+                bytesSent += outSize[p];
+                open += 2;
+            }
+        }
+
+        std::vector<pollfd> polls;
+        std::vector<int> peerOf;
+        while (open > 0)
+        {
+            polls.clear();
+            peerOf.clear();
+            for (int p = 0; p < P; p++)
+            {
+                if (p == me)
+                    continue;
+                short events = 0;
+                if (sent[p] < 8 + outSize[p])
+                    events |= POLLOUT;
+                if (got[p] < 8 || got[p] < 8 + inSize[p])
+                    events |= POLLIN;
+                if (events)
+                {
+                    polls.push_back({fds[me * P + p], events, 0});
+                    peerOf.push_back(p);
+                }
+            }
+            if (poll(polls.data(), polls.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                fail("poll");
+            }
+
+            for (size_t k = 0; k < polls.size(); k++)
+            {
+                int p = peerOf[k], fd = polls[k].fd;
+                if (polls[k].revents & (POLLERR | POLLNVAL))
+                    fail("exchange");
+
+                while ((polls[k].revents & POLLOUT) && sent[p] < 8 + outSize[p])
+                {
+                    const uint8_t *src = sent[p] < 8 ? (const uint8_t *)&outSize[p] + sent[p]
+                                                     : send[p].data() + (sent[p] - 8);
+                    size_t n = sent[p] < 8 ? 8 - sent[p] : 8 + outSize[p] - sent[p];
+                    ssize_t k2 = ::send(fd, src, n, MSG_NOSIGNAL);
+                    if (k2 < 0)
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK)
+                            break;
+                        if (errno != EINTR)
+                            fail("send");
+                        continue;
+                    }
+                    sent[p] += k2;
+                    if (sent[p] == 8 + outSize[p])
+                        open--;
+                }
+
+                while ((polls[k].revents & (POLLIN | POLLHUP)) && (got[p] < 8 || got[p] < 8 + inSize[p]))
+                {
+                    uint8_t *dst = got[p] < 8 ? (uint8_t *)&inSize[p] + got[p] : recv[p].data() + (got[p] - 8);
+                    size_t n = got[p] < 8 ? 8 - got[p] : 8 + inSize[p] - got[p];
+                    ssize_t k2 = ::recv(fd, dst, n, 0);
+                    if (k2 == 0)
+                    {
+                        fprintf(stderr, "exchange: rank %d closed the connection\n", p);
+                        exit(1);
+                    }
+                    if (k2 < 0)
+                    {
+                        if (errno == EAGAIN || errno == EWOULDBLOCK)
+                            break;
+                        if (errno != EINTR)
+                            fail("recv");
+                        continue;
+                    }
+                    got[p] += k2;
+                    if (got[p] == 8)
+                        recv[p].resize(inSize[p]);
+                    if (got[p] == 8 + inSize[p])
+                        open--;
+                }
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Fast output step for traversal results (bfs.h, dfs.h).
+ *
+ * The traversals only fill result arrays; printing is a separate, optional pass.
+ * writeVertexList() formats the numbers into one large buffer by hand and flushes it
+ * with a few fwrite calls, instead of one synchronized cout << per vertex on the
+ * traversal's hot path.
+ */
+
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <cstdio>
+#include <vector>
+
+// Writes values[0 .. n) separated by spaces and ends the line
+inline void writeVertexList(FILE *out, const int *values, size_t n)
+{
+    std::vector<char> buf(1 << 16);
+    size_t used = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (used + 16 > buf.size())
+        {
+            fwrite(buf.data(), 1, used, out);
+            used = 0;
+        }
+
+        long long x = values[i];
+        if (x < 0)
+        {
+            buf[used++] = '-';
+            x = -x;
+        }
+        char digits[12];
+        int len = 0;
+        do
+        {
+            digits[len++] = (char)('0' + x % 10);
+            x /= 10;
+        } while (x > 0);
+        while (len > 0)
+            buf[used++] = digits[--len];
+        buf[used++] = ' ';
+    }
+
+    buf[used++] = '\n';
+    fwrite(buf.data(), 1, used, out);
+    fflush(out);
+}
+
+inline void writeVertexList(FILE *out, const std::vector<int> &values)
+{
+    writeVertexList(out, values.data(), values.size());
+}
+
+#endif